@@ -22,7 +22,8 @@ public:
 	Pack & push_uint32(uint32_t u32) { write_uint32(u32); return *this; }
 	Pack & push_uint64(uint64_t u64) { write_uint64(u64); return *this; }
 
-	void reserve(size_t n) {}
+	// 已知消息长度时预先扩容，避免写入过程中多次扩容
+	void reserve(size_t n) { Serializer::reserve(n); }
 };
 
 class Unpack : public Deserializer
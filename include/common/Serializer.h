@@ -32,13 +32,22 @@
 #include <string>
 #include <sstream>
 #include <cstring>
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
 
 #include "Byteorder.h"
+#include "WordSum.h"
 #include "code/ErrorCode.h"
 
 namespace Binary
 {
-    const uint32_t  MAX_BUFFER_SIZE = std::getenv("MAX_BUFFER_SIZE") ? std::stoi(std::getenv("MAX_BUFFER_SIZE")) : 2048;
+    // 单个消息的长度上限，可由环境变量 MAX_BUFFER_SIZE 配置，首次使用时读取
+    inline size_t MaxBufferSize()
+    {
+        static const size_t maxSize = std::getenv("MAX_BUFFER_SIZE") ? std::stoul(std::getenv("MAX_BUFFER_SIZE")) : 2048;
+        return maxSize;
+    }
 
 	class Serializer;
 	class Deserializer;
@@ -52,25 +61,24 @@ namespace Binary
 		inline static uint64_t ntoh64(uint64_t i, int bo) { return bo == LITTLE_ENDIAN ? h2le64(i) : h2be64(i); }
 	};
 
+	// 数据先写入对象内的 INLINE_CAPACITY 字节缓冲区，常见的几十字节的帧构造时不分配堆内存，
+	// 超出后按两倍扩容到堆上，总长度不超过 MaxBufferSize()
 	//template<typename Encoding >
 	class Serializer
 	{
 	public:
+		static constexpr size_t INLINE_CAPACITY = 256;
+
 		//  byteOrder: LITTLE_ENDIAN / BIG_ENDIAN
 		inline Serializer(int byteOrder = LITTLE_ENDIAN)
 		: bo_(byteOrder)
 		{
-            data_ = new char[MAX_BUFFER_SIZE]();
-            memset(data_, 0, MAX_BUFFER_SIZE);
 		}
-		inline virtual ~Serializer()
-        {
-            if (data_)
-            {
-                delete[] data_;
-                data_ = nullptr;
-            }
-        }
+		inline virtual ~Serializer() = default;
+
+		// data_ 可能指向对象内的缓冲区，不可拷贝
+		Serializer(const Serializer&) = delete;
+		Serializer& operator=(const Serializer&) = delete;
 
 		inline const char* data() const
 		{
@@ -80,112 +88,143 @@ namespace Binary
 		{
 			return size_;
 		}
+		inline size_t capacity() const
+		{
+			return capacity_;
+		}
 
-		inline void write(const void* s, size_t n)
+		// 预留至少 n 字节，已写入的数据保留
+		inline void reserve(size_t n)
         {
-            if (!s || (size_ + n) > MAX_BUFFER_SIZE)
+            if (n > capacity_)
             {
-                RUNTIME_EXCEPTION("write data is null, data=" << s << ", or write not enough buffer, available buffer size=" << MAX_BUFFER_SIZE - size_ << ", need size=" << n);
+                grow(n);
             }
-            memcpy(data_, s, n);
-            size_ += n;
         }
-		inline void write_bool(bool b)
+		// 清空已写入的数据，保留已分配的缓冲区以便复用
+		inline void clear()
+        {
+            size_ = 0;
+            sumEnd_ = 0;
+            sum_ = 0;
+        }
+
+		// 从当前位置开始按 32 位小端字累加（用于帧校验和），写入过程中可多次调用 word_sum，
+		// 每次只累加上次之后新写入的完整字，整帧只遍历一遍
+		inline void begin_word_sum()
         {
-            if ((size_ + sizeof(char)) > MAX_BUFFER_SIZE)
+            sumEnd_ = size_;
+            sum_ = 0;
+        }
+		// begin_word_sum 之后写入数据的字之和，末尾不足一字的字节按补 0 计算
+		inline uint32_t word_sum()
+        {
+            const size_t words = (size_ - sumEnd_) / sizeof(uint32_t);
+            sum_ += SumWords(data_ + sumEnd_, words);
+            sumEnd_ += words * sizeof(uint32_t);
+            uint32_t tail = 0;
+            memcpy(&tail, data_ + sumEnd_, size_ - sumEnd_);
+            return sum_ + h2le32(tail);
+        }
+
+		inline void write(const void* s, size_t n)
+        {
+            if (!s && n > 0)
             {
-                RUNTIME_EXCEPTION("write bool not enough buffer, available buffer size=" << MAX_BUFFER_SIZE - size_);
+                RUNTIME_EXCEPTION("write data is null, data=" << s << ", need size=" << n);
             }
-            const char v = b ? 1 : 0;
-            *((char*)(data_ + size_)) = v;
-            size_ += sizeof(char);
+            if (n > 0)
+            {
+                memcpy(ensure(n), s, n);
+                size_ += n;
+            }
+        }
+		inline void write_bool(bool b)
+        {
+            write_byte(b ? 1 : 0);
         }
 		inline void write_byte(uint8_t u)
         {
-            if ((size_ + sizeof(char)) > MAX_BUFFER_SIZE)
-            {
-                RUNTIME_EXCEPTION("write byte not enough buffer, available buffer size=" << MAX_BUFFER_SIZE - size_);
-            }
-            *((char*)(data_ + size_)) = u;
-            size_ += sizeof(char);
+            *ensure(sizeof(uint8_t)) = static_cast<char>(u);
+            size_ += sizeof(uint8_t);
         }
 		inline void write_int16(int16_t i)
         {
-            if ((size_ + sizeof(uint16_t)) > MAX_BUFFER_SIZE)
-            {
-                RUNTIME_EXCEPTION("write int16_t not enough buffer, available buffer size=" << MAX_BUFFER_SIZE - size_);
-            }
-            *((uint16_t*)(data_ + size_)) = BO::hton16((uint16_t)i, bo_);
-            size_ += sizeof(uint16_t);
+            write_uint16((uint16_t)i);
         }
 		inline void write_int32(int32_t i)
         {
-            if ((size_ + sizeof(uint32_t)) > MAX_BUFFER_SIZE)
-            {
-                RUNTIME_EXCEPTION("write int32_t not enough buffer, available buffer size=" << MAX_BUFFER_SIZE - size_);
-            }
-            *((uint32_t*)(data_ + size_)) = BO::hton32((uint32_t)i, bo_);
-            size_ += sizeof(uint32_t);
+            write_uint32((uint32_t)i);
         }
 		inline void write_int64(int64_t i)
         {
-            if ((size_ + sizeof(uint64_t)) > MAX_BUFFER_SIZE)
-            {
-                RUNTIME_EXCEPTION("write int64_t not enough buffer, available buffer size=" << MAX_BUFFER_SIZE - size_);
-            }
-            *((uint64_t*)(data_ + size_)) = BO::hton64((uint64_t)i, bo_);
-            size_ += sizeof(uint64_t);
+            write_uint64((uint64_t)i);
         }
 		inline void write_uint16(uint16_t u)
         {
-            if ((size_ + sizeof(uint16_t)) > MAX_BUFFER_SIZE)
-            {
-                RUNTIME_EXCEPTION("write uint16_t not enough buffer, available buffer size=" << MAX_BUFFER_SIZE - size_);
-            }
-            *((uint16_t*)(data_ + size_)) = BO::hton16(u, bo_);
-            size_ += sizeof(uint16_t);
+            store(BO::hton16(u, bo_));
         }
 		inline void write_uint32(uint32_t u)
         {
-            if ((size_ + sizeof(uint32_t)) > MAX_BUFFER_SIZE)
-            {
-                RUNTIME_EXCEPTION("write uint32_t not enough buffer, available buffer size=" << MAX_BUFFER_SIZE - size_);
-            }
-            *((uint32_t*)(data_ + size_)) = BO::hton32(u, bo_);
-            size_ += sizeof(uint32_t);
+            store(BO::hton32(u, bo_));
         }
 		inline void write_uint64(uint64_t u)
         {
-            if ((size_ + sizeof(uint64_t)) > MAX_BUFFER_SIZE)
-            {
-                RUNTIME_EXCEPTION("write uint64_t not enough buffer, available buffer size=" << MAX_BUFFER_SIZE - size_);
-            }
-            *((uint64_t*)(data_ + size_)) = BO::hton64(u, bo_);
-            size_ += sizeof(uint64_t);
+            store(BO::hton64(u, bo_));
         }
 		//	real
 		inline void write_float(float f)
         {
-            if ((size_ + sizeof(uint32_t)) > MAX_BUFFER_SIZE)
+            uint32_t u32;
+            memcpy(&u32, &f, sizeof(u32));
+            write_uint32(u32);
+        }
+		inline void write_double(double d)
+        {
+            uint64_t u64;
+            memcpy(&u64, &d, sizeof(u64));
+            write_uint64(u64);
+        }
+
+	private:
+		// 按字节拷贝写入，写入位置不要求对齐
+		template <typename T>
+		inline void store(T v)
+        {
+            memcpy(ensure(sizeof(T)), &v, sizeof(T));
+            size_ += sizeof(T);
+        }
+		// 返回可写入 n 字节的位置，空间不足时扩容
+		inline char* ensure(size_t n)
+        {
+            if (n > capacity_ - size_)
             {
-                RUNTIME_EXCEPTION("write float not enough buffer, available buffer size=" << MAX_BUFFER_SIZE - size_);
+                grow(size_ + n);
             }
-            *((uint32_t*)(data_ + size_)) = BO::hton32(*((uint32_t*)&f), bo_);
-            size_ += sizeof(uint32_t);
+            return data_ + size_;
         }
-		inline void write_double(double d)
+		inline void grow(size_t need)
         {
-            if ((size_ + sizeof(uint64_t)) > MAX_BUFFER_SIZE)
+            const size_t limit = std::max<size_t>(MaxBufferSize(), INLINE_CAPACITY);
+            if (need > limit)
             {
-                RUNTIME_EXCEPTION("write double not enough buffer, available buffer size=" << MAX_BUFFER_SIZE - size_);
+                RUNTIME_EXCEPTION("write not enough buffer, max buffer size=" << limit << ", size=" << size_ << ", need size=" << need);
             }
-            *((uint64_t*)(data_ + size_)) = BO::hton64(*((uint64_t*)&d), bo_);
-            size_ += sizeof(uint64_t);
+            const size_t capacity = std::min(std::max(capacity_ * 2, need), limit);
+            std::unique_ptr<char[]> heap(new char[capacity]);
+            memcpy(heap.get(), data_, size_);
+            heap_ = std::move(heap);
+            data_ = heap_.get();
+            capacity_ = capacity;
         }
 
-	private:
-		char* data_;
+		char inline_[INLINE_CAPACITY];
+		std::unique_ptr<char[]> heap_;
+		char* data_ = inline_;
 		size_t size_ = 0;
+		size_t capacity_ = INLINE_CAPACITY;
+		size_t sumEnd_ = 0;   // 已累加到的位置
+		uint32_t sum_ = 0;
 		const int bo_ = 0;
 	};
 
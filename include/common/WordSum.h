@@ -0,0 +1,164 @@
+/*
+ * 32 位小端字累加（模 2^32），用于协议帧校验和
+ * x86 运行时检测 AVX2，否则使用 SSE2；ARM 使用 NEON；其他平台及大端主机使用标量实现
+ */
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "Byteorder.h"
+
+#if BYTE_ORDER == LITTLE_ENDIAN
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define BINARY_WORD_SUM_X86
+#include <immintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define BINARY_WORD_SUM_NEON
+#include <arm_neon.h>
+#endif
+#endif
+
+namespace Binary
+{
+    using SumWordsFunc = uint32_t (*)(const uint8_t* data, size_t words);
+
+    // 短于该字数时直接使用标量实现，省去分派和向量归约的开销
+    const size_t SIMD_MIN_WORDS = 8;
+
+    inline uint32_t SumWordsScalar(const uint8_t* data, size_t words)
+    {
+        uint32_t sum = 0;
+        for (size_t i = 0; i < words; ++i)
+        {
+            uint32_t word;
+            memcpy(&word, data + i * sizeof(uint32_t), sizeof(word));
+            sum += h2le32(word);
+        }
+        return sum;
+    }
+
+#if defined(BINARY_WORD_SUM_X86)
+#if defined(__GNUC__) && !defined(__SSE2__)
+    __attribute__((target("sse2")))
+#endif
+    inline uint32_t SumWordsSse2(const uint8_t* data, size_t words)
+    {
+        __m128i acc0 = _mm_setzero_si128();
+        __m128i acc1 = _mm_setzero_si128();
+        size_t i = 0;
+        for (; i + 8 <= words; i += 8)
+        {
+            acc0 = _mm_add_epi32(acc0, _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i * 4)));
+            acc1 = _mm_add_epi32(acc1, _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i * 4 + 16)));
+        }
+        for (; i + 4 <= words; i += 4)
+        {
+            acc0 = _mm_add_epi32(acc0, _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i * 4)));
+        }
+        acc0 = _mm_add_epi32(acc0, acc1);
+        acc0 = _mm_add_epi32(acc0, _mm_shuffle_epi32(acc0, 0x4E));
+        acc0 = _mm_add_epi32(acc0, _mm_shuffle_epi32(acc0, 0xB1));
+        return static_cast<uint32_t>(_mm_cvtsi128_si32(acc0)) + SumWordsScalar(data + i * 4, words - i);
+    }
+
+#if defined(__GNUC__)
+    __attribute__((target("avx2")))
+    inline uint32_t SumWordsAvx2(const uint8_t* data, size_t words)
+    {
+        __m256i acc0 = _mm256_setzero_si256();
+        __m256i acc1 = _mm256_setzero_si256();
+        size_t i = 0;
+        for (; i + 16 <= words; i += 16)
+        {
+            acc0 = _mm256_add_epi32(acc0, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i * 4)));
+            acc1 = _mm256_add_epi32(acc1, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i * 4 + 32)));
+        }
+        for (; i + 8 <= words; i += 8)
+        {
+            acc0 = _mm256_add_epi32(acc0, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i * 4)));
+        }
+        acc0 = _mm256_add_epi32(acc0, acc1);
+        __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(acc0), _mm256_extracti128_si256(acc0, 1));
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+        return static_cast<uint32_t>(_mm_cvtsi128_si32(sum)) + SumWordsScalar(data + i * 4, words - i);
+    }
+#endif
+#endif
+
+#if defined(BINARY_WORD_SUM_NEON)
+    inline uint32_t SumWordsNeon(const uint8_t* data, size_t words)
+    {
+        uint32x4_t acc0 = vdupq_n_u32(0);
+        uint32x4_t acc1 = vdupq_n_u32(0);
+        size_t i = 0;
+        for (; i + 8 <= words; i += 8)
+        {
+            acc0 = vaddq_u32(acc0, vreinterpretq_u32_u8(vld1q_u8(data + i * 4)));
+            acc1 = vaddq_u32(acc1, vreinterpretq_u32_u8(vld1q_u8(data + i * 4 + 16)));
+        }
+        for (; i + 4 <= words; i += 4)
+        {
+            acc0 = vaddq_u32(acc0, vreinterpretq_u32_u8(vld1q_u8(data + i * 4)));
+        }
+        acc0 = vaddq_u32(acc0, acc1);
+        const uint32_t sum = vgetq_lane_u32(acc0, 0) + vgetq_lane_u32(acc0, 1) + vgetq_lane_u32(acc0, 2) +
+                             vgetq_lane_u32(acc0, 3);
+        return sum + SumWordsScalar(data + i * 4, words - i);
+    }
+#endif
+
+    // 按 CPU 支持的指令集选择实现
+    inline SumWordsFunc SelectSumWords()
+    {
+#if defined(BINARY_WORD_SUM_X86)
+#if defined(__GNUC__)
+        if (__builtin_cpu_supports("avx2"))
+        {
+            return SumWordsAvx2;
+        }
+#endif
+        return SumWordsSse2;
+#elif defined(BINARY_WORD_SUM_NEON)
+        return SumWordsNeon;
+#else
+        return SumWordsScalar;
+#endif
+    }
+
+    inline const char* SumWordsKernelName()
+    {
+        const SumWordsFunc func = SelectSumWords();
+#if defined(BINARY_WORD_SUM_X86)
+#if defined(__GNUC__)
+        if (SumWordsAvx2 == func)
+        {
+            return "avx2";
+        }
+#endif
+        if (SumWordsSse2 == func)
+        {
+            return "sse2";
+        }
+#elif defined(BINARY_WORD_SUM_NEON)
+        if (SumWordsNeon == func)
+        {
+            return "neon";
+        }
+#endif
+        return "scalar";
+    }
+
+    // data 起的 words 个小端 32 位字之和，data 不要求对齐
+    inline uint32_t SumWords(const void* data, size_t words)
+    {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        if (words < SIMD_MIN_WORDS)
+        {
+            return SumWordsScalar(bytes, words);
+        }
+        static const SumWordsFunc func = SelectSumWords();
+        return func(bytes, words);
+    }
+}
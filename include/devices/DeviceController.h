@@ -1,4 +1,5 @@
 #pragma once
+#include <functional>
 #include <memory>
 #include <string>
 #include "devices/DeviceParams.h"
@@ -6,12 +7,20 @@
 class DeviceController
 {
 public:
+    using DeviceNameHandler = std::function<void(const std::string& name)>;
+
     static DeviceController* CreateDeviceController(const DeviceNetworkInfo& info);
 
     DeviceController(const DeviceNetworkInfo& info);
     virtual ~DeviceController() = default;
 
+    // 由 shared_ptr 托管后调用，需要 shared_from_this 的初始化放在这里
+    virtual void Init() {}
+
+    // 同步获取设备名称，等待响应时阻塞调用线程；失败时为空字符串，不抛出异常
     virtual std::string GetDeviceName(const std::string& deviceId) const = 0;
+    // 非阻塞获取设备名称，结果通过 handler 返回，失败时为空字符串；默认调用同步接口
+    virtual void AsyncGetDeviceName(const std::string& deviceId, DeviceNameHandler handler) const { handler(GetDeviceName(deviceId)); }
     virtual DeviceAddress GetDeviceAddress(const std::string& deviceId) const = 0;
     virtual DeviceVersion GetDeviceVersion(const std::string& deviceId) const = 0;
     virtual bool GetDeviceOnlineStatus(const std::string& deviceId) const = 0;
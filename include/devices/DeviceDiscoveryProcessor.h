@@ -17,12 +17,15 @@ public:
 
 
 class DeviceDiscoveryProcessor : public aoip::ResponseCallback
+                               , public aoip::UdpCallback
                                , public std::enable_shared_from_this<DeviceDiscoveryProcessor>
 {
 public:
     DeviceDiscoveryProcessor(const DeviceVendor deviceVendor);
     ~DeviceDiscoveryProcessor();
-    virtual void OnRecvResponse(const std::vector<uint8_t>& data) override;
+    virtual void OnRecvResponse(const aoip::FrameBuffer& data) override;
+    virtual bool GetFunctionCode(const aoip::FrameBuffer& response, uint16_t& functionCode) const override;
+    virtual bool GetCorrelationKey(const aoip::FrameBuffer& response, uint16_t& functionCode, uint32_t& sequence) const override;
 
     void InitProcessor(std::shared_ptr<DeviceDiscoveryObserver> ob);
     void DeviceDiscoveryRequest();
@@ -30,6 +33,7 @@ private:
     
 
     void CreateSerialConnection();
+    void HandleNetInfoResponse(const aoip::FrameBuffer& data);
 
     DeviceVendor deviceVendor_;
     std::weak_ptr<DeviceDiscoveryObserver> discoverOb_;
@@ -12,7 +12,7 @@ public:
     DigisynController(const DeviceNetworkInfo& info);
     virtual ~DigisynController() = default;
 
-    virtual std::string GetFunctionCode(const std::vector<uint8_t>& response) const override;
+    virtual bool GetFunctionCode(const aoip::FrameBuffer& response, uint16_t& functionCode) const override;
     virtual std::string GetDeviceName(const std::string& deviceId) const override;
     virtual DeviceAddress GetDeviceAddress(const std::string& deviceId) const override;
     virtual DeviceVersion GetDeviceVersion(const std::string& deviceId) const override;
@@ -1,10 +1,13 @@
 #pragma once
 #include <algorithm>
+#include <array>
 #include <map>
+#include <string_view>
 #include <vector>
 #include "Poco/Logger.h"
 #include "code/StringUtils.h"
 #include "common/Packet.h"
+#include "devices/KingrayMessageLayout.h"
 
 // 协议头
 #define PROTOCOL_HEADER 0x5A1AA1A5
@@ -62,60 +65,6 @@ enum class FunctionCode : uint16_t
     PL_FUN_UNKNOW
 };
 
-const std::map<std::string, FunctionCode> FUNCTION_CODE_MAP =
-{
-    std::pair<std::string, FunctionCode>("PL_FUN_SLAVE_RESPONSE",                  FunctionCode::PL_FUN_SLAVE_RESPONSE),
-    std::pair<std::string, FunctionCode>("PL_FUN_NETINFO_GET",                     FunctionCode::PL_FUN_NETINFO_GET),
-    std::pair<std::string, FunctionCode>("PL_FUN_NETINFO_SET",                     FunctionCode::PL_FUN_NETINFO_SET),
-    std::pair<std::string, FunctionCode>("PL_FUN_DEVICE_MARK",                     FunctionCode::PL_FUN_DEVICE_MARK),
-    std::pair<std::string, FunctionCode>("PL_FUN_AUDIO_CONFIG_GET",                FunctionCode::PL_FUN_AUDIO_CONFIG_GET),               
-    std::pair<std::string, FunctionCode>("PL_FUN_AUDIO_CONFIG_SET",                FunctionCode::PL_FUN_AUDIO_CONFIG_SET),               
-    std::pair<std::string, FunctionCode>("PL_FUN_STARTUP_PRESET_SET",              FunctionCode::PL_FUN_STARTUP_PRESET_SET),            
-    std::pair<std::string, FunctionCode>("PL_FUN_PRESET_INFO_GET",                 FunctionCode::PL_FUN_PRESET_INFO_GET),               
-    std::pair<std::string, FunctionCode>("PL_FUN_PRESET_SAVE",                     FunctionCode::PL_FUN_PRESET_SAVE),                   
-    std::pair<std::string, FunctionCode>("PL_FUN_PRESET_CALL",                     FunctionCode::PL_FUN_PRESET_CALL),                   
-    std::pair<std::string, FunctionCode>("PL_FUN_PRESET_NAME_GET",                 FunctionCode::PL_FUN_PRESET_NAME_GET),               
-    std::pair<std::string, FunctionCode>("PL_FUN_PRESET_DELETE",                   FunctionCode::PL_FUN_PRESET_DELETE),                 
-    std::pair<std::string, FunctionCode>("PL_FUN_NETINFO_GET",                     FunctionCode::PL_FUN_NETINFO_GET),                    
-    std::pair<std::string, FunctionCode>("PL_FUN_NETINFO_SET",                     FunctionCode::PL_FUN_NETINFO_SET),                    
-    std::pair<std::string, FunctionCode>("PL_FUN_DEVICE_MARK",                     FunctionCode::PL_FUN_DEVICE_MARK),                    
-    std::pair<std::string, FunctionCode>("PL_FUN_GROUP_CODE_GET",                  FunctionCode::PL_FUN_GROUP_CODE_GET),                 
-    std::pair<std::string, FunctionCode>("PL_FUN_GROUP_CODE_SET",                  FunctionCode::PL_FUN_GROUP_CODE_SET),                 
-    std::pair<std::string, FunctionCode>("PL_FUN_MEETING_PARAM_GET",               FunctionCode::PL_FUN_MEETING_PARAM_GET),              
-    std::pair<std::string, FunctionCode>("PL_FUN_MEETING_PARAM_SET",               FunctionCode::PL_FUN_MEETING_PARAM_SET),              
-    std::pair<std::string, FunctionCode>("PL_FUN_WL_MIC_FREQ_ALLOW_SET",           FunctionCode::PL_FUN_WL_MIC_FREQ_ALLOW_SET),          
-    std::pair<std::string, FunctionCode>("PL_FUN_PAIR_MODE_GET",                   FunctionCode::PL_FUN_PAIR_MODE_GET),                  
-    std::pair<std::string, FunctionCode>("PL_FUN_PAIR_MODE_SET",                   FunctionCode::PL_FUN_PAIR_MODE_SET),                  
-    std::pair<std::string, FunctionCode>("PL_FUN_MANUAL_PAIRING_SET",              FunctionCode::PL_FUN_MANUAL_PAIRING_SET),             
-    std::pair<std::string, FunctionCode>("PL_FUN_WL_DEV_REMOVE",                   FunctionCode::PL_FUN_WL_DEV_REMOVE),                  
-    std::pair<std::string, FunctionCode>("PL_FUN_CODE_REASSIGN_SET",               FunctionCode::PL_FUN_CODE_REASSIGN_SET),              
-    std::pair<std::string, FunctionCode>("PL_FUN_RST_FACT_SET",                    FunctionCode::PL_FUN_RST_FACT_SET),                   
-    std::pair<std::string, FunctionCode>("PL_FUN_WL_HOST_INFO_GET",                FunctionCode::PL_FUN_WL_HOST_INFO_GET),               
-    std::pair<std::string, FunctionCode>("PL_FUN_AES_MDL_INFO_GET",                FunctionCode::PL_FUN_AES_MDL_INFO_GET),              
-    std::pair<std::string, FunctionCode>("PL_FUN_MEETING_DEV_CODE_GET",            FunctionCode::PL_FUN_MEETING_DEV_CODE_GET),           
-    std::pair<std::string, FunctionCode>("PL_FUN_SINGLE_DEV_CODE_SET",             FunctionCode::PL_FUN_SINGLE_DEV_CODE_SET),            
-    std::pair<std::string, FunctionCode>("PL_FUN_WL_HOST_NAME_GET",                FunctionCode::PL_FUN_WL_HOST_NAME_GET),               
-    std::pair<std::string, FunctionCode>("PL_FUN_WL_HOST_NAME_SET",                FunctionCode::PL_FUN_WL_HOST_NAME_SET),               
-    std::pair<std::string, FunctionCode>("PL_FUN_ALL_MIC_ID_TYPE_GET",             FunctionCode::PL_FUN_ALL_MIC_ID_TYPE_GET),            
-    std::pair<std::string, FunctionCode>("PL_FUN_SINGLE_MIC_ID_TYPE_SET",          FunctionCode::PL_FUN_SINGLE_MIC_ID_TYPE_SET),         
-    std::pair<std::string, FunctionCode>("PL_FUN_ALL_WL_MIC_BTERY_LVL_GET",        FunctionCode::PL_FUN_ALL_WL_MIC_BTERY_LVL_GET),       
-    std::pair<std::string, FunctionCode>("PL_FUN_ALL_MIC_SPEAKER_VOL_GET",         FunctionCode::PL_FUN_ALL_MIC_SPEAKER_VOL_GET),        
-    std::pair<std::string, FunctionCode>("PL_FUN_SINGLE_DEV_VOL_SET",              FunctionCode::PL_FUN_SINGLE_DEV_VOL_SET),             
-    std::pair<std::string, FunctionCode>("PL_FUN_ALL_MIC_SPEAKER_VER_GET",         FunctionCode::PL_FUN_ALL_MIC_SPEAKER_VER_GET),        
-    std::pair<std::string, FunctionCode>("PL_FUN_MEETING_DEV_CLK_STA_GET",         FunctionCode::PL_FUN_MEETING_DEV_CLK_STA_GET),        
-    std::pair<std::string, FunctionCode>("PL_FUN_SINGLE_DEV_CLK_STA_SET",          FunctionCode::PL_FUN_SINGLE_DEV_CLK_STA_SET),         
-    std::pair<std::string, FunctionCode>("PL_FUN_MEETING_DEV_NET_STA_GET",         FunctionCode::PL_FUN_MEETING_DEV_NET_STA_GET),        
-    std::pair<std::string, FunctionCode>("PL_FUN_SINGLE_DEV_NET_STA_SET",          FunctionCode::PL_FUN_SINGLE_DEV_NET_STA_SET),         
-    std::pair<std::string, FunctionCode>("PL_FUN_MEETING_DEV_EVENT_STA_GET",       FunctionCode::PL_FUN_MEETING_DEV_EVENT_STA_GET),      
-    std::pair<std::string, FunctionCode>("PL_FUN_ALL_WL_WD_MIC_SPEAKER_TYPE_GET",  FunctionCode::PL_FUN_ALL_WL_WD_MIC_SPEAKER_TYPE_GET), 
-    std::pair<std::string, FunctionCode>("PL_FUN_ALL_MIC_SPEAKER_DEV_NAME_GET",    FunctionCode::PL_FUN_ALL_MIC_SPEAKER_DEV_NAME_GET),   
-    std::pair<std::string, FunctionCode>("PL_FUN_SINGLE_MIC_SPEAKER_DEV_NAME_SET", FunctionCode::PL_FUN_SINGLE_MIC_SPEAKER_DEV_NAME_SET),
-    std::pair<std::string, FunctionCode>("PL_FUN_ALL_DEV_ONLINE_GET",              FunctionCode::PL_FUN_ALL_DEV_ONLINE_GET),             
-    std::pair<std::string, FunctionCode>("PL_FUN_ALL_DEV_CHN_CFG_GET",             FunctionCode::PL_FUN_ALL_DEV_CHN_CFG_GET),            
-    std::pair<std::string, FunctionCode>("PL_FUN_SINGLE_DEV_CHN_CFG_SET",          FunctionCode::PL_FUN_SINGLE_DEV_CHN_CFG_SET),         
-    std::pair<std::string, FunctionCode>("PL_FUN_SINGLE_DEVICE_NAME_GET",          FunctionCode::PL_FUN_SINGLE_DEVICE_NAME_GET)                
-};
-
 enum class ResponseCode : uint32_t
 {
     NO_ERROR            = 0x00000000,  // 无错误
@@ -124,21 +73,6 @@ enum class ResponseCode : uint32_t
     FUNCTION_CODE_ERROR = 0x00000005   // 功能号错误
 };
 
-// 功能号转字符串
-inline std::string GetFunctionCodeStr(const uint16_t code)
-{
-    std::string codeStr = "unknowCode";
-    auto it = std::find_if(FUNCTION_CODE_MAP.begin(), FUNCTION_CODE_MAP.end(),
-                           [&code](const std::pair<const std::string, FunctionCode>& pair)
-                           { return FunctionCode(code) == pair.second; });
-
-    if (it != FUNCTION_CODE_MAP.end())
-    {
-        codeStr = it->first;
-    }
-    return codeStr;
-}
-
 struct MessageHeader
 {
     uint32_t frameHeader_  = PROTOCOL_HEADER;
@@ -163,25 +97,20 @@ struct DeviceTypeBaseInfo
     uint8_t reserve_[3] = {0};
 };
 
-// 计算校验和
-inline uint32_t CalculateChecksum(uint32_t dataLen, const uint32_t* data)
+// 按设备类型批量查询的响应消息体为 deviceType(u8) | reserve(u8) | 记录数组，末尾补齐到整字
+const size_t DEVICE_RECORDS_OFFSET = 2;
+
+// 计算校验和，data 为 dataLen 个字的消息体，不要求对齐
+inline uint32_t CalculateChecksum(uint32_t dataLen, const void* data)
 {
-    auto sum = dataLen;
-    for (auto i = 0; i < dataLen; i++)
-    {
-        sum += data[i];
-    }
-    sum = ~sum + 1;
-    return sum;
+    const uint32_t sum = dataLen + Binary::SumWords(data, dataLen);
+    return ~sum + 1;
 }
 
-// 验证检验和
-inline void VerifyChecksum(uint32_t currentChecksum, uint32_t checksum)
+// 验证检验和，一致时返回 true
+inline bool VerifyChecksum(uint32_t currentChecksum, uint32_t checksum)
 {
-    if (currentChecksum != checksum)
-    {
-        std::runtime_error("data error!");
-    }
+    return currentChecksum == checksum;
 }
 
 // 公共部分，消息头
@@ -205,14 +134,77 @@ protected:
     Poco::Logger& logger_;
 };
 
-// 获取功能号
-inline uint16_t GetFunctionCodeByData(const std::vector<uint8_t>& data)
+// 消息头的字节数
+const size_t MESSAGE_HEADER_SIZE = 12;
+
+// 消息头的只读视图：只校验长度和帧头标识，按偏移直接读取接收缓冲区，不复制、不分配，也不抛出异常
+// 收包时分派帧只需读取消息头，无需构造 CommonMessage；数据需在视图使用期间有效
+class FrameHeaderView
+{
+public:
+    constexpr FrameHeaderView(const uint8_t* data, size_t size)
+        : data_(size >= MESSAGE_HEADER_SIZE && PROTOCOL_HEADER == KingrayLayout::LoadInt<uint32_t>(data) ? data : nullptr)
+    {
+    }
+    FrameHeaderView(const void* data, size_t size) : FrameHeaderView(static_cast<const uint8_t*>(data), size) {}
+
+    constexpr bool Valid() const { return nullptr != data_; }
+    // 以下读取需先确认 Valid()
+    constexpr uint32_t GetProductID() const { return KingrayLayout::LoadInt<uint32_t>(data_ + 4); }
+    constexpr uint16_t GetDeviceID() const { return KingrayLayout::LoadInt<uint16_t>(data_ + 8); }
+    constexpr uint16_t GetFunctionCode() const { return KingrayLayout::LoadInt<uint16_t>(data_ + 10); }
+    constexpr MessageHeader Header() const
+    {
+        return MessageHeader{PROTOCOL_HEADER, GetProductID(), GetDeviceID(), GetFunctionCode()};
+    }
+
+private:
+    const uint8_t* data_ = nullptr;
+};
+
+// 接收帧的只读视图：构造时校验一次帧头、长度和校验和，消息体按偏移直接读取接收缓冲区，不复制
+// 数据需在视图使用期间有效（如持有 FrameBuffer）
+class KingrayFrameView
+{
+public:
+    KingrayFrameView(const void* data, size_t size)
+    {
+        const FrameHeaderView header(data, size);
+        if (!header.Valid())
+        {
+            return;
+        }
+        header_ = header.Header();
+        body_ = KingrayLayout::BodyView(static_cast<const uint8_t*>(data) + MESSAGE_HEADER_SIZE, size - MESSAGE_HEADER_SIZE);
+    }
+
+    bool Valid() const { return body_.Valid(); }
+    const MessageHeader& Header() const { return header_; }
+    const KingrayLayout::BodyView& Body() const { return body_; }
+
+private:
+    MessageHeader header_;
+    KingrayLayout::BodyView body_;
+};
+
+// 获取功能号，帧头不符时返回 0
+inline uint16_t GetFunctionCodeByData(const void* data, size_t size)
 {
-    Binary::Unpack unpack(data.data(), data.size());
-    CommonMessage message;
-    message.Deserialize(unpack);
+    const FrameHeaderView header(data, size);
+    return header.Valid() ? header.GetFunctionCode() : 0;
+}
 
-    return message.messageHeader_.functionCode_;
+// 读取消息头中的 (功能号, 设备ID) 作为请求/响应关联键，帧头不符时返回 false
+inline bool GetCorrelationKeyByData(const void* data, size_t size, uint16_t& functionCode, uint32_t& sequence)
+{
+    const FrameHeaderView header(data, size);
+    if (!header.Valid())
+    {
+        return false;
+    }
+    functionCode = header.GetFunctionCode();
+    sequence = header.GetDeviceID();
+    return true;
 }
 
 /********************************************通信消息********************************************************/
@@ -503,7 +495,7 @@ struct PairModeInfo
 class PairModeGetResponseMsg : public CommonMessage
 {
 public:
-    PairModeSetRequestMsg(uint16_t functionCode = static_cast<uint16_t>(FunctionCode::PL_FUN_PAIR_MODE_SET))
+    PairModeGetResponseMsg(uint16_t functionCode = static_cast<uint16_t>(FunctionCode::PL_FUN_PAIR_MODE_GET))
         : CommonMessage(functionCode)
     {
     }
@@ -737,6 +729,9 @@ public:
     };
     uint8_t deviceType_ = 0;    // 设备类型
     std::vector<IdTypeInfo> idTypeInfoVec_;
+
+    // 直接引用接收缓冲区的记录，迭代时解码，不分配内存
+    static KingrayLayout::RecordRange<IdTypeInfo> GetIdTypeInfos(const KingrayLayout::BodyView& body);
 };
 
 // 设置单一MIC身份类别请求消息
@@ -808,6 +803,8 @@ public:
     uint8_t deviceType_ = 0;    // 设备类型
     uint8_t reserve_    = 0;
     std::vector<VolumeInfo> volumeInfoVec_;
+
+    static KingrayLayout::RecordRange<VolumeInfo> GetVolumeInfos(const KingrayLayout::BodyView& body);
 };
 
 // 设置单一设备音量状态请求消息
@@ -1042,6 +1039,8 @@ public:
     uint8_t deviceType_ = 0;    // 设备类型
     uint8_t reserve_    = 0;
     std::vector<DetailInfo> detailInfoVec_;
+
+    static KingrayLayout::RecordRange<DetailInfo> GetDetailInfos(const KingrayLayout::BodyView& body);
 };
 
 // 获取全部设备名称请求消息
@@ -1069,10 +1068,19 @@ public:
         uint16_t    deviceCode_; // 设备编码
         std::string name_;       // 设备名称，不超过24字节
     };
+    // 线上记录为 deviceCode(u16) | name(24字节，不足时以 0 结尾)，name_ 指向接收缓冲区
+    struct NameInfoView
+    {
+        static constexpr size_t NAME_SIZE = 24;
+        uint16_t         deviceCode_ = 0;
+        std::string_view name_;
+    };
     
     uint8_t deviceType_ = 0;    // 设备类型
     uint8_t reserve_    = 0;
     std::vector<NameInfo> nameInfoVec_;
+
+    static KingrayLayout::RecordRange<NameInfoView> GetNameInfos(const KingrayLayout::BodyView& body);
 };
 
 // 设置单一设备名称请求消息（有线MIC/无线MIC/POE音箱）
@@ -1125,6 +1133,8 @@ public:
     uint8_t deviceType_ = 0;    // 设备类型
     uint8_t reserve_    = 0;
     std::vector<OnlineInfo> onlineInfoVec_;
+
+    static KingrayLayout::RecordRange<OnlineInfo> GetOnlineInfos(const KingrayLayout::BodyView& body);
 };
 
 // 获取全部设备通道配置请求消息(全部主控主机/无线主机/有线MIC/无线MIC/POE音箱)
@@ -1200,6 +1210,8 @@ public:
 class SingleDeviceNameGetResponseMsg : public CommonMessage
 {
 public:
+    static constexpr size_t NAME_SIZE = 24;  // 名称字段固定长度，不足时以 '\0' 或空格填充
+
     virtual void DeserializeBody(const Binary::Unpack& unpack) override;
 
     std::string name_;  // 设备名称，不超过24字节
@@ -1965,3 +1977,155 @@ public:
     };
     AutoMixOutInfo autoMixOutInfo_;
 };
+
+/********************************************消息体布局********************************************************/
+// 定长消息体的字段顺序，编解码由 KingrayLayout::PackBody/UnpackBody 按编译期偏移生成
+BOOST_HANA_ADAPT_STRUCT(NetworkInfo, mac_, ip_, mask_, gw_, dhcpMode_, reserve_);
+BOOST_HANA_ADAPT_STRUCT(DeviceTypeBaseInfo, deviceType_, reserve_);
+BOOST_HANA_ADAPT_STRUCT(GroupInfo, groupCode_, reserve_);
+BOOST_HANA_ADAPT_STRUCT(MeetingParam, meetingMode_, wlMicSpeechMax_, wdMicSpeechMax_, reserve_);
+BOOST_HANA_ADAPT_STRUCT(PairModeInfo, deviceType_, pairMode_, reserve_);
+BOOST_HANA_ADAPT_STRUCT(DeviceMarkRequestMsg::DeviceMark, action_, deviceType_, deviceCode_);
+BOOST_HANA_ADAPT_STRUCT(WlMicFreqAllowSetRequestMsg::FreqAllowInfo, action_, reserve_);
+BOOST_HANA_ADAPT_STRUCT(ManualPairingSetRequestMsg::ManualPairingInfo, deviceType_, action_, reserve_);
+BOOST_HANA_ADAPT_STRUCT(DeviceRemoveRequestMsg::DeviceCodeInfo, deviceType_, reserve_, deviceCode_);
+BOOST_HANA_ADAPT_STRUCT(SingleDevVolSetRequestMsg::SingleDevVolumeInfo, deviceType_, reserve0_, deviceCode_, mute_, reserve1_, volume_);
+
+// 批量查询响应的记录
+BOOST_HANA_ADAPT_STRUCT(MicIdTypeGetResponseMsg::IdTypeInfo, deviceCode_, idType_);
+BOOST_HANA_ADAPT_STRUCT(AllMicSpeakerVolGetResponseMsg::VolumeInfo, deviceCode_, mute_, reserve_, volume_);
+BOOST_HANA_ADAPT_STRUCT(AllWlWdSpeakerTypeGetResponseMsg::DetailInfo, deviceCode_, detailType_);
+BOOST_HANA_ADAPT_STRUCT(AllDeviceOnlineResponseMsg::OnlineInfo, deviceCode_, online_, reserve_);
+
+namespace KingrayLayout
+{
+template <>
+struct Record<AllMicSpeakerDevNameResponseMsg::NameInfoView>
+{
+    using NameInfoView = AllMicSpeakerDevNameResponseMsg::NameInfoView;
+    static constexpr size_t SIZE = sizeof(uint16_t) + NameInfoView::NAME_SIZE;
+    static NameInfoView Load(const uint8_t* in)
+    {
+        NameInfoView record;
+        record.deviceCode_ = LoadInt<uint16_t>(in);
+        const char* name = reinterpret_cast<const char*>(in + sizeof(uint16_t));
+        record.name_ = std::string_view(name, strnlen(name, NameInfoView::NAME_SIZE));
+        return record;
+    }
+};
+}  // namespace KingrayLayout
+
+/********************************************功能号表********************************************************/
+struct FunctionCodeInfo
+{
+    const char* name_ = nullptr;  // 功能号名称，只用于日志
+};
+
+struct FunctionCodeEntry
+{
+    FunctionCode     code_;
+    FunctionCodeInfo info_;
+};
+
+#define FUNCTION_CODE_ENTRY(code) FunctionCodeEntry{FunctionCode::code, FunctionCodeInfo{#code}}
+
+constexpr FunctionCodeEntry FUNCTION_CODE_ENTRIES[] =
+{
+    FUNCTION_CODE_ENTRY(PL_FUN_SLAVE_RESPONSE),
+    FUNCTION_CODE_ENTRY(PL_FUN_AUDIO_CONFIG_GET),
+    FUNCTION_CODE_ENTRY(PL_FUN_AUDIO_CONFIG_SET),
+    FUNCTION_CODE_ENTRY(PL_FUN_STARTUP_PRESET_SET),
+    FUNCTION_CODE_ENTRY(PL_FUN_PRESET_INFO_GET),
+    FUNCTION_CODE_ENTRY(PL_FUN_PRESET_SAVE),
+    FUNCTION_CODE_ENTRY(PL_FUN_PRESET_CALL),
+    FUNCTION_CODE_ENTRY(PL_FUN_PRESET_NAME_GET),
+    FUNCTION_CODE_ENTRY(PL_FUN_PRESET_DELETE),
+    FUNCTION_CODE_ENTRY(PL_FUN_NETINFO_GET),
+    FUNCTION_CODE_ENTRY(PL_FUN_NETINFO_SET),
+    FUNCTION_CODE_ENTRY(PL_FUN_DEVICE_MARK),
+    FUNCTION_CODE_ENTRY(PL_FUN_GROUP_CODE_GET),
+    FUNCTION_CODE_ENTRY(PL_FUN_GROUP_CODE_SET),
+    FUNCTION_CODE_ENTRY(PL_FUN_MEETING_PARAM_GET),
+    FUNCTION_CODE_ENTRY(PL_FUN_MEETING_PARAM_SET),
+    FUNCTION_CODE_ENTRY(PL_FUN_WL_MIC_FREQ_ALLOW_SET),
+    FUNCTION_CODE_ENTRY(PL_FUN_PAIR_MODE_GET),
+    FUNCTION_CODE_ENTRY(PL_FUN_PAIR_MODE_SET),
+    FUNCTION_CODE_ENTRY(PL_FUN_MANUAL_PAIRING_SET),
+    FUNCTION_CODE_ENTRY(PL_FUN_WL_DEV_REMOVE),
+    FUNCTION_CODE_ENTRY(PL_FUN_CODE_REASSIGN_SET),
+    FUNCTION_CODE_ENTRY(PL_FUN_RST_FACT_SET),
+    FUNCTION_CODE_ENTRY(PL_FUN_WL_HOST_INFO_GET),
+    FUNCTION_CODE_ENTRY(PL_FUN_AES_MDL_INFO_GET),
+    FUNCTION_CODE_ENTRY(PL_FUN_MEETING_DEV_CODE_GET),
+    FUNCTION_CODE_ENTRY(PL_FUN_SINGLE_DEV_CODE_SET),
+    FUNCTION_CODE_ENTRY(PL_FUN_WL_HOST_NAME_GET),
+    FUNCTION_CODE_ENTRY(PL_FUN_WL_HOST_NAME_SET),
+    FUNCTION_CODE_ENTRY(PL_FUN_ALL_MIC_ID_TYPE_GET),
+    FUNCTION_CODE_ENTRY(PL_FUN_SINGLE_MIC_ID_TYPE_SET),
+    FUNCTION_CODE_ENTRY(PL_FUN_ALL_WL_MIC_BTERY_LVL_GET),
+    FUNCTION_CODE_ENTRY(PL_FUN_ALL_MIC_SPEAKER_VOL_GET),
+    FUNCTION_CODE_ENTRY(PL_FUN_SINGLE_DEV_VOL_SET),
+    FUNCTION_CODE_ENTRY(PL_FUN_ALL_MIC_SPEAKER_VER_GET),
+    FUNCTION_CODE_ENTRY(PL_FUN_MEETING_DEV_CLK_STA_GET),
+    FUNCTION_CODE_ENTRY(PL_FUN_SINGLE_DEV_CLK_STA_SET),
+    FUNCTION_CODE_ENTRY(PL_FUN_MEETING_DEV_NET_STA_GET),
+    FUNCTION_CODE_ENTRY(PL_FUN_SINGLE_DEV_NET_STA_SET),
+    FUNCTION_CODE_ENTRY(PL_FUN_MEETING_DEV_EVENT_STA_GET),
+    FUNCTION_CODE_ENTRY(PL_FUN_ALL_WL_WD_MIC_SPEAKER_TYPE_GET),
+    FUNCTION_CODE_ENTRY(PL_FUN_ALL_MIC_SPEAKER_DEV_NAME_GET),
+    FUNCTION_CODE_ENTRY(PL_FUN_SINGLE_MIC_SPEAKER_DEV_NAME_SET),
+    FUNCTION_CODE_ENTRY(PL_FUN_ALL_DEV_ONLINE_GET),
+    FUNCTION_CODE_ENTRY(PL_FUN_ALL_DEV_CHN_CFG_GET),
+    FUNCTION_CODE_ENTRY(PL_FUN_SINGLE_DEV_CHN_CFG_SET),
+    FUNCTION_CODE_ENTRY(PL_FUN_SINGLE_DEVICE_NAME_GET),
+};
+
+#undef FUNCTION_CODE_ENTRY
+
+// 功能号均小于 PL_FUN_UNKNOW，按功能号直接索引
+constexpr size_t FUNCTION_CODE_TABLE_SIZE = static_cast<size_t>(FunctionCode::PL_FUN_UNKNOW);
+
+constexpr bool CheckFunctionCodeEntries()
+{
+    bool seen[FUNCTION_CODE_TABLE_SIZE] = {};
+    for (const auto& entry : FUNCTION_CODE_ENTRIES)
+    {
+        const auto code = static_cast<size_t>(entry.code_);
+        if (code >= FUNCTION_CODE_TABLE_SIZE || seen[code])
+        {
+            return false;
+        }
+        seen[code] = true;
+    }
+    return true;
+}
+static_assert(CheckFunctionCodeEntries(), "function code entries must be unique and below PL_FUN_UNKNOW");
+
+constexpr std::array<FunctionCodeInfo, FUNCTION_CODE_TABLE_SIZE> MakeFunctionCodeTable()
+{
+    std::array<FunctionCodeInfo, FUNCTION_CODE_TABLE_SIZE> table{};
+    for (const auto& entry : FUNCTION_CODE_ENTRIES)
+    {
+        table[static_cast<size_t>(entry.code_)] = entry.info_;
+    }
+    return table;
+}
+
+inline constexpr std::array<FunctionCodeInfo, FUNCTION_CODE_TABLE_SIZE> FUNCTION_CODE_TABLE = MakeFunctionCodeTable();
+
+// 未知功能号返回 nullptr
+inline const FunctionCodeInfo* GetFunctionCodeInfo(uint16_t code)
+{
+    if (code >= FUNCTION_CODE_TABLE_SIZE || !FUNCTION_CODE_TABLE[code].name_)
+    {
+        return nullptr;
+    }
+    return &FUNCTION_CODE_TABLE[code];
+}
+
+// 功能号名称，只用于日志
+inline const char* GetFunctionCodeName(uint16_t code)
+{
+    const auto* info = GetFunctionCodeInfo(code);
+    return info ? info->name_ : "unknowCode";
+}
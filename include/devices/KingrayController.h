@@ -16,8 +16,12 @@ public:
     KingrayController(const DeviceNetworkInfo& info);
     virtual ~KingrayController() = default;
 
-    virtual std::string GetFunctionCode(const std::vector<uint8_t>& response) const override; 
+    virtual void Init() override;
+
+    virtual bool GetFunctionCode(const aoip::FrameBuffer& response, uint16_t& functionCode) const override;
+    virtual bool GetCorrelationKey(const aoip::FrameBuffer& response, uint16_t& functionCode, uint32_t& sequence) const override;
     virtual std::string GetDeviceName(const std::string& deviceId) const override;
+    virtual void AsyncGetDeviceName(const std::string& deviceId, DeviceNameHandler handler) const override;
     virtual DeviceAddress GetDeviceAddress(const std::string& deviceId) const override;
     virtual DeviceVersion GetDeviceVersion(const std::string& deviceId) const override;
     virtual bool GetDeviceOnlineStatus(const std::string& deviceId) const override;
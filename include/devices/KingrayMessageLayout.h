@@ -0,0 +1,281 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <boost/hana.hpp>
+#include "code/ErrorCode.h"
+#include "common/Packet.h"
+
+/**
+ * Kingray 消息体的编译期布局描述
+ * 消息体结构体用 BOOST_HANA_ADAPT_STRUCT 声明字段顺序，字段为整数或整数数组，按声明顺序紧密排列、小端编码。
+ * 各字段偏移和消息体长度在编译期确定，打包和解包展开为定长的读写，不再逐个字段流式读写、手工计算 dataLen。
+ * 线上格式：dataLen(u32，单位为字) | 消息体 | checksum(u32，dataLen 与消息体各字之和取负)
+ */
+namespace KingrayLayout
+{
+namespace hana = boost::hana;
+
+// 小端读写，与主机字节序无关，编译器会合并为单次读写
+template <typename F>
+constexpr void StoreInt(uint8_t* out, F value)
+{
+    using U = std::make_unsigned_t<F>;
+    const U u = static_cast<U>(value);
+    for (size_t i = 0; i < sizeof(U); ++i)
+    {
+        out[i] = static_cast<uint8_t>(u >> (8 * i));
+    }
+}
+
+template <typename F>
+constexpr F LoadInt(const uint8_t* in)
+{
+    using U = std::make_unsigned_t<F>;
+    U u = 0;
+    for (size_t i = 0; i < sizeof(U); ++i)
+    {
+        u |= static_cast<U>(static_cast<U>(in[i]) << (8 * i));
+    }
+    return static_cast<F>(u);
+}
+
+// 字段的线上长度和编解码，未特化的类型不能出现在消息体中
+template <typename F, typename = void>
+struct Field;
+
+template <typename F>
+struct Field<F, std::enable_if_t<std::is_integral<F>::value && !std::is_same<F, bool>::value>>
+{
+    static constexpr size_t SIZE = sizeof(F);
+    static constexpr void Store(uint8_t* out, const F& value) { StoreInt(out, value); }
+    static constexpr void Load(const uint8_t* in, F& value) { value = LoadInt<F>(in); }
+};
+
+template <typename F, size_t N>
+struct Field<F[N]>
+{
+    static constexpr size_t SIZE = Field<F>::SIZE * N;
+    static constexpr void Store(uint8_t* out, const F (&value)[N])
+    {
+        for (size_t i = 0; i < N; ++i)
+        {
+            Field<F>::Store(out + i * Field<F>::SIZE, value[i]);
+        }
+    }
+    static constexpr void Load(const uint8_t* in, F (&value)[N])
+    {
+        for (size_t i = 0; i < N; ++i)
+        {
+            Field<F>::Load(in + i * Field<F>::SIZE, value[i]);
+        }
+    }
+};
+
+// 由 hana 访问器得到成员类型
+template <typename T, typename Accessor>
+using MemberType = std::remove_cv_t<std::remove_reference_t<decltype(
+    hana::second(std::declval<Accessor>())(std::declval<T&>()))>>;
+
+template <typename T>
+constexpr size_t CalculateBodySize()
+{
+    size_t size = 0;
+    hana::for_each(hana::accessors<T>(), [&size](auto accessor) {
+        size += Field<MemberType<T, decltype(accessor)>>::SIZE;
+    });
+    return size;
+}
+
+// 声明了布局的结构体按字段顺序编解码，可以嵌套
+template <typename F>
+struct Field<F, std::enable_if_t<hana::Struct<F>::value>>
+{
+    static constexpr size_t SIZE = CalculateBodySize<F>();
+    static void Store(uint8_t* out, const F& value)
+    {
+        hana::for_each(hana::accessors<F>(), [&out, &value](auto accessor) {
+            using M = MemberType<F, decltype(accessor)>;
+            Field<M>::Store(out, hana::second(accessor)(value));
+            out += Field<M>::SIZE;
+        });
+    }
+    static void Load(const uint8_t* in, F& value)
+    {
+        hana::for_each(hana::accessors<F>(), [&in, &value](auto accessor) {
+            using M = MemberType<F, decltype(accessor)>;
+            Field<M>::Load(in, hana::second(accessor)(value));
+            in += Field<M>::SIZE;
+        });
+    }
+};
+
+// 消息体的字节数
+template <typename T>
+constexpr size_t BODY_SIZE = Field<T>::SIZE;
+
+// 按字计算校验和，words 包括开头的 dataLen
+inline uint32_t CalculateChecksum(const uint8_t* data, size_t words)
+{
+    return ~Binary::SumWords(data, words) + 1;
+}
+
+// 数组记录的线上长度和解码，默认按声明的布局解码；含变长内容的记录（如名称）特化该模板，返回指向接收缓冲区的视图
+template <typename R, typename = void>
+struct Record
+{
+    static constexpr size_t SIZE = Field<R>::SIZE;
+    static R Load(const uint8_t* in)
+    {
+        R record;
+        Field<R>::Load(in, record);
+        return record;
+    }
+};
+
+// 定长记录数组的惰性视图，迭代时才从缓冲区解码，不分配内存；缓冲区需在使用期间有效
+template <typename R>
+class RecordRange
+{
+public:
+    class Iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = R;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = const R*;
+        using reference         = R;
+
+        Iterator() = default;
+        explicit Iterator(const uint8_t* pos) : pos_(pos) {}
+
+        R operator*() const { return Record<R>::Load(pos_); }
+        Iterator& operator++()
+        {
+            pos_ += Record<R>::SIZE;
+            return *this;
+        }
+        Iterator operator++(int)
+        {
+            Iterator it = *this;
+            ++(*this);
+            return it;
+        }
+        bool operator==(const Iterator& other) const { return pos_ == other.pos_; }
+        bool operator!=(const Iterator& other) const { return pos_ != other.pos_; }
+
+    private:
+        const uint8_t* pos_ = nullptr;
+    };
+
+    RecordRange() = default;
+    RecordRange(const uint8_t* data, size_t count) : data_(data), count_(count) {}
+
+    Iterator begin() const { return Iterator(data_); }
+    Iterator end() const { return Iterator(data_ + count_ * Record<R>::SIZE); }
+    size_t size() const { return count_; }
+    bool empty() const { return 0 == count_; }
+    R operator[](size_t i) const { return Record<R>::Load(data_ + i * Record<R>::SIZE); }
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t count_ = 0;
+};
+
+// dataLen | 消息体 | checksum 的只读视图，构造时校验一次长度和校验和，之后按偏移直接读取接收缓冲区
+class BodyView
+{
+public:
+    BodyView() = default;
+    // data 指向 dataLen 字段，size 为其后（含 dataLen）的可用字节数；长度或校验和错误时 Valid() 为 false
+    BodyView(const uint8_t* data, size_t size)
+    {
+        if (size < 2 * sizeof(uint32_t))
+        {
+            return;
+        }
+        // 以字数比较，避免 dataLen * 4 在 32 位 size_t 上溢出
+        const uint32_t dataLen = LoadInt<uint32_t>(data);
+        if (dataLen > (size - 2 * sizeof(uint32_t)) / sizeof(uint32_t))
+        {
+            return;
+        }
+        const size_t bodySize = static_cast<size_t>(dataLen) * sizeof(uint32_t);
+        const uint8_t* body = data + sizeof(uint32_t);
+        if (CalculateChecksum(data, 1 + bodySize / sizeof(uint32_t)) != LoadInt<uint32_t>(body + bodySize))
+        {
+            return;
+        }
+        data_ = body;
+        size_ = bodySize;
+    }
+    // 从 unpack 当前位置解析并越过整个消息体，格式错误时抛出异常
+    explicit BodyView(const Binary::Unpack& unpack)
+        : BodyView(reinterpret_cast<const uint8_t*>(unpack.data()), unpack.size())
+    {
+        if (!Valid())
+        {
+            RUNTIME_EXCEPTION("invalid message body, size=" << unpack.size());
+        }
+        unpack.skip(sizeof(uint32_t) + size_ + sizeof(uint32_t));
+    }
+
+    bool Valid() const { return nullptr != data_; }
+    const uint8_t* data() const { return data_; }
+    // 消息体字节数，即 dataLen * 4
+    size_t size() const { return size_; }
+
+    // 读取 offset 处的定长字段或结构体
+    template <typename T>
+    void Read(size_t offset, T& value) const
+    {
+        if (offset > size_ || size_ - offset < Field<T>::SIZE)
+        {
+            RUNTIME_EXCEPTION("read out of message body, body size=" << size_ << ", offset=" << offset
+                                                                    << ", need size=" << Field<T>::SIZE);
+        }
+        Field<T>::Load(data_ + offset, value);
+    }
+
+    // offset 之后直到消息体末尾的记录数组，末尾不足一条记录的字节为补齐的填充
+    template <typename R>
+    RecordRange<R> Records(size_t offset) const
+    {
+        if (offset > size_)
+        {
+            return RecordRange<R>();
+        }
+        return RecordRange<R>(data_ + offset, (size_ - offset) / Record<R>::SIZE);
+    }
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+// 编码 dataLen、消息体和校验和，先在栈上按固定偏移写好整段再一次追加到 pack
+template <typename T>
+inline void PackBody(Binary::Pack& pack, const T& body)
+{
+    constexpr size_t bodySize = BODY_SIZE<T>;
+    static_assert(0 == bodySize % sizeof(uint32_t), "Kingray message body must be a whole number of words");
+    constexpr uint32_t dataLen = bodySize / sizeof(uint32_t);
+
+    std::array<uint8_t, sizeof(uint32_t) + bodySize + sizeof(uint32_t)> out;
+    StoreInt(out.data(), dataLen);
+    Field<T>::Store(out.data() + sizeof(uint32_t), body);
+    StoreInt(out.data() + sizeof(uint32_t) + bodySize, CalculateChecksum(out.data(), 1 + dataLen));
+    pack.push(out.data(), out.size());
+}
+
+// 解码并校验 dataLen 和校验和；dataLen 超出消息体长度时忽略多出的字（由新版本协议追加的字段）
+template <typename T>
+inline void UnpackBody(const Binary::Unpack& unpack, T& body)
+{
+    BodyView(unpack).Read(0, body);
+}
+
+}  // namespace KingrayLayout
@@ -1,85 +1,107 @@
 #pragma once
 
 #include <atomic>
-#include <chrono>
 #include <future>
-#include <map>
 #include <memory>
-#include <mutex>
 #include <string>
-#include <thread>
 #include <vector>
 
-#include "UdpSocket.h"
+#include "BufferPool.h"
+#include "RequestEngine.h"
+#include "TransportRuntime.h"
 
 namespace aoip
 {
-struct ProtocolConfig
+// UDP 链路参数，超时、重传和节流参数见 RequestConfig
+struct ProtocolConfig : RequestConfig
 {
     std::string masterIp_{"0.0.0.0"};
     uint16_t slavePort_{50000};
     uint16_t masterPort_{60000};
-    uint32_t timeoutMs_{1000};
-    uint32_t maxRetries_{3};
     uint32_t productId_{0x02020483};
     uint16_t deviceId_{0xFFFF};
     bool broadcast_{true};
     size_t recvBufferSize_{4096};
+    std::string multicastIp_;         // 设备组播组，非空时 Start 后加入，接收发往该组 slavePort_ 的状态流
+    uint16_t multicastPort_{0};       // SendMulticast 的目标端口
+    std::string multicastInterface_;  // 组播使用的本地接口地址，为空时由系统按路由选择
+    uint8_t multicastTtl_{1};
+    // 单播时为本设备使用独立的已连接 socket（同样绑定 slavePort_），发送免去每次的路由查找，
+    // 内核只把该设备的数据报投递给它；要求设备从 masterPort_ 应答
+    bool connected_{false};
+    // 本地端口的接收分片数（SO_REUSEPORT），大量主机同时应答时按 I/O 线程扩展接收，以首个创建通道的实例为准；
+    // 多分片时广播模式的实例和事件订阅会从多个接收线程收到帧，不被支持（构造和 Subscribe 时抛出异常）
+    size_t receiveShards_{1};
 };
 
-struct Request
-{
-    std::string functionCode_;
-    std::promise<std::vector<uint8_t>> promise_;
-    std::chrono::steady_clock::time_point timestamp_;
-    uint32_t timeoutMs_;
-
-    Request(const std::string& functionCode, uint32_t timeoutMs)
-        : functionCode_(functionCode), timestamp_(std::chrono::steady_clock::now()), timeoutMs_(timeoutMs) {}
-};
+class AsyncProtocol;
 
-class UdpCallback
+// 批量请求项，用于向多个设备扇出同一轮轮询
+struct BatchRequest
 {
-public:
-    virtual std::string GetFunctionCode(const std::vector<uint8_t>& response) const = 0;
+    AsyncProtocol* protocol_{nullptr};  // 为空时该项以异常结束
+    uint16_t functionCode_{0};
+    uint32_t sequence_{0};
+    const void* data_{nullptr};
+    size_t len_{0};
+    ResponseHandler handler_;  // 非空时以回调完成，对应的 future 无效
+    RequestPriority priority_{RequestPriority::BACKGROUND};  // 批量轮询默认按后台处理
 };
 
-class RequestManager
+// 基于 Reactor 的异步请求/响应协议，收包与超时均由事件循环驱动，不再占用独立线程
+// socket 和 I/O 线程来自 TransportRuntime，同一本地端口的协议实例共享一个通道；请求处理由 RequestEngine 完成
+class AsyncProtocol : private Transport
 {
    public:
-    uint32_t AddRequest(std::shared_ptr<Request> request);
-    bool MatchResponse(const std::vector<uint8_t>& response);
-    void CleanTimeouts();
-    void SetUdpCallback(std::shared_ptr<UdpCallback> cb);
-   private:
-    std::mutex mutex_;
-    uint32_t nextRequestId_{0};
-    std::map<uint32_t, std::shared_ptr<Request>> requests_;
-    std::weak_ptr<UdpCallback> udpCallback_;
-};
-
-class AsyncProtocol
-{
-   public:
-    explicit AsyncProtocol(const ProtocolConfig& config);
+    explicit AsyncProtocol(const ProtocolConfig& config, TransportRuntime& runtime = TransportRuntime::Instance());
     ~AsyncProtocol();
 
     void Start();
     void Stop();
-    std::future<std::vector<uint8_t>> SendRequest(const std::string& funcCode, const void* data, size_t len);
+    // 只按功能号关联响应，同一功能号同时只应有一个在途请求
+    std::future<FrameBuffer> SendRequest(uint16_t functionCode, const void* data, size_t len);
+    // 按 (端点, 功能号, 序列号) 关联的请求，同一功能号可同时存在多个在途请求
+    // priority 决定节流排队时的放行顺序，用户操作应使用 INTERACTIVE
+    std::future<FrameBuffer> SendRequest(uint16_t functionCode, uint32_t sequence, const void* data, size_t len,
+                                         RequestPriority priority = RequestPriority::NORMAL);
+    // 非阻塞版本：立即返回，响应或失败时在事件循环线程回调 handler，调用线程不必等待
+    void SendRequest(uint16_t functionCode, uint32_t sequence, const void* data, size_t len, ResponseHandler handler,
+                     RequestPriority priority = RequestPriority::NORMAL);
+    // 向 multicastIp_:multicastPort_ 发送一次，组内设备（如一组话筒的静音）同时生效，不跟踪响应；
+    // 设备的应答或状态上报作为未匹配帧交给事件订阅
+    bool SendMulticast(const void* data, size_t len);
+    // 批量发送，同一通道上的请求合并为一次 sendmmsg，返回的 future 与 requests 一一对应；
+    // 无法登记的请求（未指定协议、协议未启动、与在途请求冲突）只以异常结束其自身的 future 或回调，不影响其余请求
+    static std::vector<std::future<FrameBuffer>> SendRequests(const std::vector<BatchRequest>& requests);
     void SetUdpCallback(std::shared_ptr<UdpCallback> cb);
+    // 本端点的节流指标（同一端点的协议实例共享）
+    PacerMetrics GetPacerMetrics() const { return engine_->GetPacerMetrics(); }
+
+    // 订阅设备主动上报的帧（未匹配在途请求的帧），按 UdpCallback::GetCorrelationKey 解析出的功能号和序列号过滤，
+    // 默认接收全部；多个订阅同时匹配时各自收到一份，帧数据共享不复制
+    std::shared_ptr<EventSubscription> Subscribe(uint32_t functionCode = EventSubscription::ANY_FUNCTION_CODE,
+                                                 uint64_t sequence = EventSubscription::ANY_SEQUENCE,
+                                                 size_t capacity = DEFAULT_EVENT_QUEUE_SIZE,
+                                                 EventSubscription::Notifier notifier = nullptr);
+    // 返回后该订阅不会再有事件入队
+    void Unsubscribe(const std::shared_ptr<EventSubscription>& subscription);
+
+    static constexpr size_t DEFAULT_EVENT_QUEUE_SIZE = RequestEngine::DEFAULT_EVENT_QUEUE_SIZE;
 
    private:
     static UdpConfig MakeUDPConfig(const ProtocolConfig& config);
-    void ReceiverLoop();
-    void TimeoutLoop();
+    Datagram MakeDatagram(const void* data, size_t len) const;
+    // Transport：端点已预解析，广播和单播都不再逐次解析地址
+    bool Transmit(const FrameBuffer& frame) override;
+    void Sync() override;
 
     ProtocolConfig config_;
-    std::unique_ptr<UdpSocket> socket_;
-    std::unique_ptr<RequestManager> requestManager_;
-    std::atomic<bool> running_{false};
-    std::thread receiverThread_;
-    std::thread timeoutThread_;
+    Endpoint master_;  // 预解析的设备端点，广播模式下为广播地址
+    Endpoint group_;   // 预解析的组播端点
+    std::shared_ptr<UdpChannel> channel_;
+    std::unique_ptr<RequestEngine> engine_;
+    uint64_t sinkId_{0};
+    bool joinedGroup_{false};
 };
 
-}  // namespace aoip
\ No newline at end of file
+}  // namespace aoip
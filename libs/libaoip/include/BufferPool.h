@@ -0,0 +1,94 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace aoip
+{
+
+class BufferPool;
+
+// 引用计数的帧缓冲视图，拷贝只增加引用计数，不复制数据
+// 最后一个视图释放时帧归还缓冲池；data()/size() 与 std::vector 一致，可直接交给 Binary::Unpack
+class FrameBuffer
+{
+   public:
+    FrameBuffer() = default;
+    FrameBuffer(const FrameBuffer& other);
+    FrameBuffer(FrameBuffer&& other) noexcept;
+    FrameBuffer& operator=(const FrameBuffer& other);
+    FrameBuffer& operator=(FrameBuffer&& other) noexcept;
+    ~FrameBuffer();
+
+    const uint8_t* data() const;
+    size_t size() const { return size_; }
+    bool empty() const { return 0 == size_; }
+
+    // 写入接口只应在帧被共享前（填充接收数据时）使用
+    uint8_t* MutableData();
+    size_t Capacity() const;
+    void Resize(size_t size);
+
+    // 共享同一帧的子视图
+    FrameBuffer Slice(size_t offset, size_t len) const;
+    std::vector<uint8_t> ToVector() const { return std::vector<uint8_t>(data(), data() + size_); }
+
+   private:
+    friend class BufferPool;
+
+    struct Frame
+    {
+        std::atomic<uint32_t> refs_{0};
+        BufferPool* pool_{nullptr};  // 为空表示堆分配，释放时直接删除
+        uint8_t* data_{nullptr};
+        size_t capacity_{0};
+    };
+
+    FrameBuffer(Frame* frame, size_t size);
+    void Reset();
+
+    Frame* frame_{nullptr};
+    size_t offset_{0};
+    size_t size_{0};
+};
+
+// 定长帧缓冲池，帧内存一次性从 slab 分配，收包路径上不再有堆分配
+class BufferPool
+{
+   public:
+    static constexpr size_t FRAME_SIZE = 2048;
+    static constexpr size_t DEFAULT_FRAME_COUNT = 1024;
+
+    // 进程级缓冲池，不随静态对象析构，保证退出阶段仍在使用的帧可以安全归还
+    static BufferPool& Instance()
+    {
+        static BufferPool* instance = new BufferPool();
+        return *instance;
+    }
+
+    explicit BufferPool(size_t frameCount = DEFAULT_FRAME_COUNT, size_t frameSize = FRAME_SIZE);
+    ~BufferPool();
+
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    // 返回 size() == size 的帧；池已耗尽或 size 超过帧大小时退化为堆分配
+    FrameBuffer Acquire(size_t size = FRAME_SIZE);
+    size_t Available() const;
+
+   private:
+    friend class FrameBuffer;
+    void Release(FrameBuffer::Frame* frame);
+
+    size_t frameSize_;
+    std::unique_ptr<uint8_t[]> slab_;
+    std::unique_ptr<FrameBuffer::Frame[]> frames_;
+    mutable std::mutex mutex_;
+    std::vector<FrameBuffer::Frame*> freeList_;
+};
+
+}  // namespace aoip
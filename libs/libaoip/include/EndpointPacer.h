@@ -0,0 +1,106 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "Reactor.h"
+
+namespace aoip
+{
+
+// 请求优先级，数值越小越优先
+enum class RequestPriority : uint8_t
+{
+    INTERACTIVE = 0,  // 用户操作：静音、音量、闪烁等
+    NORMAL = 1,
+    BACKGROUND = 2,   // 后台轮询：在线状态、电量等
+};
+
+// 默认不节流；需要限速的设备由其协议实例单独配置
+struct PacerConfig
+{
+    uint32_t maxInFlight_{0};    // 在途请求窗口，0 表示不限制
+    uint32_t ratePerSecond_{0};  // 令牌桶速率，0 表示不限速
+    uint32_t burst_{16};         // 令牌桶容量
+
+    bool Unlimited() const { return 0 == maxInFlight_ && 0 == ratePerSecond_; }
+};
+
+struct PacerMetrics
+{
+    size_t pending_{0};      // 排队等待发送的请求数
+    std::array<size_t, 3> pendingByPriority_{};  // 按 RequestPriority 分类的排队数
+    uint32_t inFlight_{0};   // 已发送未完成的请求数
+    uint64_t admitted_{0};   // 累计放行数
+    uint64_t throttled_{0};  // 累计因窗口或令牌不足而排队的次数
+};
+
+// 单个设备端点的发送节流：在途窗口 + 令牌桶，超出部分按优先级排队，同级 FIFO
+// 放行时高优先级先于已排队的低优先级；窗口大于 1 时为非后台请求保留一个位置，后台轮询不会占满窗口
+// 同一端点的多个协议实例共享一个 pacer，由 UdpChannel 分配
+class EndpointPacer : public std::enable_shared_from_this<EndpointPacer>
+{
+   public:
+    using Task = std::function<void()>;
+
+    EndpointPacer(const PacerConfig& config, std::shared_ptr<Reactor> reactor);
+
+    EndpointPacer(const EndpointPacer&) = delete;
+    EndpointPacer& operator=(const EndpointPacer&) = delete;
+
+    // 可立即发送时占用窗口并返回 true，由调用方发送；否则排队，放行时执行 task（同样已占用窗口）
+    bool Admit(const void* owner, RequestPriority priority, Task task);
+    // 放行过的请求结束（响应、失败或取消）时调用一次，释放窗口并放行排队请求
+    void Release();
+    // 移除 owner 的排队任务，并等待其已出队、正在其他线程执行的任务结束，返回移除个数；
+    // 返回后不会再执行 owner 的任务，owner 可以安全销毁。不能在 owner 的任务中调用
+    size_t Cancel(const void* owner);
+
+    PacerMetrics GetMetrics() const;
+
+   private:
+    using Clock = std::chrono::steady_clock;
+
+    struct PendingTask
+    {
+        const void* owner_;
+        Task task_;
+    };
+
+    static constexpr size_t PRIORITY_COUNT = 3;
+
+    void Refill(Clock::time_point now);
+    uint32_t WindowFor(RequestPriority priority) const;
+    // 窗口与令牌都满足时占用一份，需持有锁
+    bool TryTake(Clock::time_point now, RequestPriority priority);
+    // 同级及更高优先级是否有排队，需持有锁
+    bool HasPendingAtOrAbove(RequestPriority priority) const;
+    size_t PendingCount() const;
+    void Drain();
+    // 仅因令牌不足而阻塞时，定时到下一个令牌产生再放行，需持有锁
+    void ScheduleDrain();
+
+    PacerConfig config_;
+    std::shared_ptr<Reactor> reactor_;
+
+    mutable std::mutex mutex_;
+    std::array<std::deque<PendingTask>, PRIORITY_COUNT> pending_;
+    // 已出队尚未执行完的任务所属 owner，Drain 在锁外执行任务期间由 Cancel 等待
+    std::vector<const void*> running_;
+    std::condition_variable runningDone_;
+    double tokens_;
+    Clock::time_point lastRefill_;
+    uint32_t inFlight_{0};
+    bool drainScheduled_{false};
+    uint64_t admitted_{0};
+    uint64_t throttled_{0};
+};
+
+}  // namespace aoip
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+
+#include "BufferPool.h"
+#include "SpscQueue.h"
+
+namespace aoip
+{
+
+// 设备主动上报的帧（未匹配任何在途请求），fromIp_/fromPort_ 为网络字节序
+struct EventFrame
+{
+    FrameBuffer frame_;
+    uint16_t functionCode_{0};
+    uint32_t sequence_{0};
+    uint32_t fromIp_{0};
+    uint16_t fromPort_{0};
+};
+
+// 事件订阅：按功能号和序列号(设备ID)过滤上报帧，经无锁队列交给订阅方
+// 入队在传输层事件循环线程，Poll 只能由一个线程调用；队列满时丢弃新事件并计数
+class EventSubscription
+{
+   public:
+    static constexpr uint32_t ANY_FUNCTION_CODE = 0xFFFFFFFF;
+    static constexpr uint64_t ANY_SEQUENCE = 0xFFFFFFFFFFFFFFFF;
+
+    // 入队后在事件循环线程回调，用于唤醒订阅方，不应在其中阻塞
+    using Notifier = std::function<void()>;
+
+    EventSubscription(uint32_t functionCode, uint64_t sequence, size_t capacity, Notifier notifier)
+        : functionCode_(functionCode), sequence_(sequence), queue_(capacity), notifier_(std::move(notifier))
+    {
+    }
+
+    EventSubscription(const EventSubscription&) = delete;
+    EventSubscription& operator=(const EventSubscription&) = delete;
+
+    // 非阻塞取出一个事件，队列为空时返回 false
+    bool Poll(EventFrame& event) { return queue_.TryPop(event); }
+    // 因队列满被丢弃的事件数
+    uint64_t GetDropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+    // 无法解析功能号的帧只交给不过滤的订阅
+    bool Matches(bool parsed, uint16_t functionCode, uint32_t sequence) const
+    {
+        if (!parsed)
+        {
+            return ANY_FUNCTION_CODE == functionCode_ && ANY_SEQUENCE == sequence_;
+        }
+        return (ANY_FUNCTION_CODE == functionCode_ || functionCode_ == functionCode) &&
+               (ANY_SEQUENCE == sequence_ || sequence_ == sequence);
+    }
+
+    // 由事件循环线程调用，返回是否入队
+    bool Publish(const EventFrame& event)
+    {
+        if (!queue_.TryPush(event))
+        {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        if (notifier_)
+        {
+            notifier_();
+        }
+        return true;
+    }
+
+   private:
+    uint32_t functionCode_;
+    uint64_t sequence_;
+    SpscQueue<EventFrame> queue_;
+    Notifier notifier_;
+    std::atomic<uint64_t> dropped_{0};
+};
+
+}  // namespace aoip
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "TimerWheel.h"
+
+namespace aoip
+{
+
+// 基于 epoll 的事件循环，单线程复用多个 fd，并用时间轮驱动定时任务
+// 无事件、无定时器时阻塞在 epoll_wait，空闲 CPU 占用为 0
+class Reactor
+{
+   public:
+    using EventHandler = std::function<void()>;
+    using Task = std::function<void()>;
+
+    Reactor();
+    ~Reactor();
+
+    Reactor(const Reactor&) = delete;
+    Reactor& operator=(const Reactor&) = delete;
+
+    void Start();
+    void Stop();
+    // 将事件循环线程绑定到指定 CPU，可在 Start 前后调用，cpu < 0 表示不绑定
+    bool SetCpuAffinity(int cpu);
+    bool IsRunning() const { return running_; }
+    bool IsInLoopThread() const { return std::this_thread::get_id() == loopThreadId_.load(); }
+
+    // fd 可读时在事件循环线程回调（水平触发）
+    bool AddHandler(int fd, EventHandler handler);
+    // 移除后保证不再有该 fd 的回调在执行
+    void RemoveHandler(int fd);
+
+    // 定时任务在事件循环线程执行，返回定时器ID
+    uint64_t RunAfter(uint32_t delayMs, Task task);
+    bool CancelTimer(uint64_t timerId);
+
+    // 投递任务到事件循环线程执行，循环未运行时在调用线程直接执行
+    void Post(Task task);
+    // 等待已投递的任务和正在执行的回调完成
+    void Sync();
+
+   private:
+    void Loop();
+    // 需持有 taskMutex_ 且线程已启动
+    bool ApplyCpuAffinity();
+    void Wakeup();
+    void DrainWakeup();
+    int PrepareWait();
+    void RunExpiredTimers();
+    void RunPendingTasks();
+
+    static constexpr int MAX_EVENTS = 64;
+
+    int epollFd_{-1};
+    int wakeupFd_{-1};
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+    std::atomic<std::thread::id> loopThreadId_;
+    int cpu_{-1};
+
+    std::mutex handlerMutex_;
+    std::unordered_map<int, std::shared_ptr<EventHandler>> handlers_;
+
+    std::mutex taskMutex_;
+    std::vector<Task> pendingTasks_;
+
+    std::mutex timerMutex_;
+    TimerWheel timerWheel_;
+    TimerWheel::Clock::time_point nextWakeup_{TimerWheel::Clock::time_point::max()};
+};
+
+}  // namespace aoip
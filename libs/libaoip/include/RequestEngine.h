@@ -0,0 +1,269 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "BufferPool.h"
+#include "EndpointPacer.h"
+#include "EventSubscription.h"
+#include "Reactor.h"
+#include "RttEstimator.h"
+#include "UdpSocket.h"
+
+namespace aoip
+{
+// 请求/响应的超时、重传和节流参数，与具体链路无关
+struct RequestConfig
+{
+    uint32_t timeoutMs_{1000};    // 尚无 RTT 样本时的超时，也是单次发送的超时上限
+    uint32_t minTimeoutMs_{20};   // 自适应超时下限
+    uint32_t maxRetries_{3};      // 超时后的最大重传次数
+    PacerConfig pacer_;           // 每个设备端点的在途窗口和发送速率
+};
+
+// 请求关联键：(源端点, 数值功能号, 序列号/设备ID)
+// ip_/port_ 为网络字节序，广播模式下为 0 表示匹配任意来源
+struct RequestKey
+{
+    uint32_t ip_{0};
+    uint16_t port_{0};
+    uint16_t functionCode_{0};
+    uint32_t sequence_{0};
+
+    bool operator==(const RequestKey& other) const
+    {
+        return ip_ == other.ip_ && port_ == other.port_ && functionCode_ == other.functionCode_ &&
+               sequence_ == other.sequence_;
+    }
+};
+
+struct RequestKeyHash
+{
+    size_t operator()(const RequestKey& key) const
+    {
+        const uint64_t high = (static_cast<uint64_t>(key.ip_) << 16) | key.port_;
+        const uint64_t low = (static_cast<uint64_t>(key.functionCode_) << 32) | key.sequence_;
+        return std::hash<uint64_t>()(high * 0x9E3779B97F4A7C15ULL ^ low);
+    }
+};
+
+// 响应回调，在传输层事件循环线程执行（Stop 取消的请求在调用 Stop 的线程，无法登记的请求在发送线程），
+// 不应在其中阻塞；error 非空表示请求失败（超时、协议停止或与在途请求冲突），此时 response 为空
+using ResponseHandler = std::function<void(const FrameBuffer& response, std::exception_ptr error)>;
+
+struct Request
+{
+    uint16_t functionCode_{0};  // 未指定序列号的请求只按功能号关联
+    std::promise<FrameBuffer> promise_;
+    ResponseHandler handler_;  // 非空时以回调完成，否则通过 promise_ 完成
+    std::chrono::steady_clock::time_point timestamp_;
+    uint32_t timeoutMs_;
+    RequestKey key_;
+    bool keyed_{false};
+    uint64_t timerId_{0};  // 时间轮上的超时定时器
+    FrameBuffer payload_;  // 重传用的报文
+    uint32_t attempts_{0};  // 已发送次数，排队等待节流时为 0
+    RequestPriority priority_{RequestPriority::NORMAL};
+    bool admitted_{false};  // 是否占用了节流窗口，结束时需要释放
+    uint64_t bodyHash_{0};  // 请求报文哈希，用于合并相同的在途请求
+    size_t bodyLen_{0};
+    std::vector<std::shared_ptr<Request>> followers_;  // 合并到本请求的等待者，随本请求一起完成
+
+    Request(uint16_t functionCode, uint32_t timeoutMs)
+        : functionCode_(functionCode), timestamp_(std::chrono::steady_clock::now()), timeoutMs_(timeoutMs) {}
+
+    Request(const RequestKey& key, uint32_t timeoutMs)
+        : timestamp_(std::chrono::steady_clock::now()), timeoutMs_(timeoutMs), key_(key), keyed_(true) {}
+
+    // 保存报文用于排队发送和重传，并计算合并相同请求用的哈希
+    void SetPayload(const void* data, size_t len);
+    void Complete(const FrameBuffer& response);
+    void Fail(std::exception_ptr error);
+};
+
+class UdpCallback
+{
+public:
+    virtual ~UdpCallback() = default;
+    // 解析响应中的数值功能号，用于关联未指定序列号的请求，返回 false 表示无法解析
+    virtual bool GetFunctionCode(const FrameBuffer& response, uint16_t& functionCode) const = 0;
+    // 解析响应中的数值功能号和序列号(设备ID)，返回 false 表示不支持按序列号关联
+    virtual bool GetCorrelationKey(const FrameBuffer& /*response*/, uint16_t& /*functionCode*/, uint32_t& /*sequence*/) const
+    {
+        return false;
+    }
+};
+
+class RequestManager
+{
+   public:
+    using Transmitter = std::function<void(const FrameBuffer& payload)>;
+
+    enum class AddResult
+    {
+        SEND,       // 已放行并挂载超时定时器，由调用方发送
+        QUEUED,     // 节流排队中，放行时由 RequestManager 通过 transmitter 发送
+        COALESCED,  // 已合并到相同的在途请求，无需发送
+        REJECTED,   // 已有键相同而报文不同的在途请求，未登记
+        STOPPED     // 未启动或已停止，未登记
+    };
+
+    // 同一 RequestManager 的请求都发往同一端点，共用一个 RTT 估计；pacer 为空表示不节流
+    RequestManager(std::shared_ptr<Reactor> reactor, const RequestConfig& config, Transmitter transmitter,
+                   std::shared_ptr<EndpointPacer> pacer = nullptr);
+
+    // 登记请求；放行后按当前 RTO 在时间轮上挂载超时定时器
+    // 已有相同 (端点, 功能号, 序列号, 报文) 的在途请求时合并为其等待者；键相同而报文不同时不登记
+    AddResult AddRequest(std::shared_ptr<Request> request);
+    // fromIp/fromPort 为网络字节序的响应来源，用于按序列号关联
+    bool MatchResponse(const FrameBuffer& response, uint32_t fromIp = 0, uint16_t fromPort = 0);
+    // 超时定时器到期回调，在事件循环线程执行：未达重传上限时退避重发，否则以超时结束
+    void ExpireRequest(uint32_t requestId);
+    // 开始接受新请求
+    void Start();
+    // 停止接受新请求，并以异常结束全部在途请求；与并发的 AddRequest 在分片锁内交汇，返回后不会再有请求登记或挂载定时器
+    void Stop(const std::string& reason);
+    void SetUdpCallback(std::shared_ptr<UdpCallback> cb);
+   private:
+    using RequestMap = std::map<uint32_t, std::shared_ptr<Request>>;
+
+    // 在途请求按关联键分片加锁，多个接收线程和发送线程各自只锁所在分片
+    struct Shard
+    {
+        std::mutex mutex_;
+        RequestMap requests_;
+        // 按序列号关联的在途请求 <RequestKey, requestId>
+        std::unordered_map<RequestKey, uint32_t, RequestKeyHash> keyedRequests_;
+    };
+
+    static constexpr uint32_t SHARD_BITS = 3;
+    static constexpr uint32_t SHARD_COUNT = 1u << SHARD_BITS;
+
+    // 关联键决定分片，requestId 低位记录分片；按功能号关联的请求都在分片 0，保持先发先匹配
+    Shard& ShardOf(uint32_t requestId) { return shards_[requestId & (SHARD_COUNT - 1)]; }
+    uint32_t ShardIndex(const Request& request) const;
+    std::shared_ptr<Request> TakeKeyedRequest(const RequestKey& key);
+    std::shared_ptr<Request> TakeFunctionCodeRequest(uint16_t functionCode);
+    // 取出已匹配的请求并更新 RTT 估计
+    std::shared_ptr<Request> TakeRequest(Shard& shard, RequestMap::iterator it);
+    std::shared_ptr<Request> EraseRequest(Shard& shard, RequestMap::iterator it);
+    uint32_t GetTimeoutMs(const Request& request);
+    void CompleteRequest(const std::shared_ptr<Request>& request, const FrameBuffer& response);
+    void ArmTimer(const std::shared_ptr<Request>& request, uint32_t requestId, uint32_t timeoutMs);
+    // 节流放行排队的请求，首次发送
+    void SendQueued(uint32_t requestId);
+    // 释放请求占用的节流窗口，不能持有分片锁调用
+    void ReleaseWindow(const std::shared_ptr<Request>& request);
+    // 在 [timeoutMs * (1 - RETRY_JITTER), timeoutMs * (1 + RETRY_JITTER)] 内随机，避免多设备同步重传，需持有 rttMutex_
+    uint32_t Jitter(uint32_t timeoutMs);
+
+    static constexpr double RETRY_JITTER = 0.2;
+
+    std::shared_ptr<Reactor> reactor_;
+    Transmitter transmitter_;
+    std::shared_ptr<EndpointPacer> pacer_;
+    uint32_t maxRetries_;
+    std::array<Shard, SHARD_COUNT> shards_;
+    std::atomic<uint32_t> nextRequestId_{0};
+    std::atomic<bool> accepting_{false};  // 在分片锁内读取，Stop 先清除再逐个锁分片
+    // 保护 RTT 估计和随机数，只在分片锁内或无锁时获取，顺序为 分片锁 -> rttMutex_
+    std::mutex rttMutex_;
+    RttEstimator rttEstimator_;
+    std::minstd_rand random_;
+    std::weak_ptr<UdpCallback> udpCallback_;
+};
+
+// 请求引擎使用的链路，UDP 为数据报，串口为字节流（分帧后交给引擎）
+class Transport
+{
+   public:
+    virtual ~Transport() = default;
+    // 发送一帧，可能在调用线程或引擎的事件循环线程（排队放行、重传）调用；
+    // 返回 false 表示未交给链路，由超时重传补发
+    virtual bool Transmit(const FrameBuffer& frame) = 0;
+    // 等待正在执行的收包回调结束
+    virtual void Sync() = 0;
+};
+
+// 与链路无关的请求/响应引擎：关联、自适应超时与重传、节流、相同请求合并、事件订阅
+// 链路收到的每一帧交给 OnReceive，发送经 Transport；UDP 和串口共用同一套实现
+class RequestEngine
+{
+   public:
+    // peer 为关联键中的对端端点，响应来源不确定（广播、串口）时传无效端点，匹配任意来源；
+    // pacer 为空表示不节流；transport 需比引擎存活更久
+    RequestEngine(std::shared_ptr<Reactor> reactor, const RequestConfig& config, Transport& transport,
+                  const Endpoint& peer = Endpoint(), std::shared_ptr<EndpointPacer> pacer = nullptr);
+
+    RequestEngine(const RequestEngine&) = delete;
+    RequestEngine& operator=(const RequestEngine&) = delete;
+
+    void Start();
+    // 以 reason 结束全部在途请求，返回后超时回调不再执行
+    void Stop(const std::string& reason);
+    bool IsRunning() const { return running_; }
+
+    // 只按功能号关联响应，同一功能号同时只应有一个在途请求
+    std::future<FrameBuffer> SendRequest(uint16_t functionCode, const void* data, size_t len);
+    // 按 (端点, 功能号, 序列号) 关联的请求，同一功能号可同时存在多个在途请求
+    std::future<FrameBuffer> SendRequest(uint16_t functionCode, uint32_t sequence, const void* data, size_t len,
+                                         RequestPriority priority = RequestPriority::NORMAL);
+    void SendRequest(uint16_t functionCode, uint32_t sequence, const void* data, size_t len, ResponseHandler handler,
+                     RequestPriority priority = RequestPriority::NORMAL);
+
+    std::shared_ptr<Request> MakeRequest(uint16_t functionCode, uint32_t sequence, RequestPriority priority) const;
+    // 登记请求，不发送；返回 false 表示已合并到在途请求或正在节流排队，由引擎负责，
+    // 或请求无法登记（协议未启动、与在途请求冲突），此时已以异常结束该请求，不抛出；
+    // 返回 true 时由调用方发送（批量发送时合并为一次系统调用）
+    bool Register(const std::shared_ptr<Request>& request, const void* data, size_t len);
+
+    // 链路收到的帧：先匹配在途请求，未匹配的视为设备主动上报交给订阅，返回是否被消费
+    // fromIp/fromPort 为网络字节序的来源，仅在 peer 有效时参与关联
+    bool OnReceive(const FrameBuffer& frame, uint32_t fromIp = 0, uint16_t fromPort = 0);
+
+    // 订阅设备主动上报的帧，按关联回调解析出的功能号和序列号过滤，默认接收全部；
+    // 多个订阅同时匹配时各自收到一份，帧数据共享不复制
+    std::shared_ptr<EventSubscription> Subscribe(uint32_t functionCode = EventSubscription::ANY_FUNCTION_CODE,
+                                                 uint64_t sequence = EventSubscription::ANY_SEQUENCE,
+                                                 size_t capacity = DEFAULT_EVENT_QUEUE_SIZE,
+                                                 EventSubscription::Notifier notifier = nullptr);
+    // 返回后该订阅不会再有事件入队
+    void Unsubscribe(const std::shared_ptr<EventSubscription>& subscription);
+
+    // 解析响应的关联键，同时用于事件过滤
+    void SetCorrelationCallback(std::shared_ptr<UdpCallback> cb);
+    PacerMetrics GetPacerMetrics() const { return pacer_ ? pacer_->GetMetrics() : PacerMetrics(); }
+
+    static constexpr size_t DEFAULT_EVENT_QUEUE_SIZE = 256;
+
+   private:
+    using SubscriptionList = std::vector<std::shared_ptr<EventSubscription>>;
+
+    void Send(const std::shared_ptr<Request>& request, const void* data, size_t len);
+    // 分发未匹配请求的帧，返回是否有订阅接收
+    bool DispatchEvent(const FrameBuffer& frame, uint32_t fromIp, uint16_t fromPort);
+
+    RequestConfig config_;
+    std::shared_ptr<Reactor> reactor_;
+    Transport& transport_;
+    Endpoint peer_;
+    std::shared_ptr<EndpointPacer> pacer_;
+    RequestManager requestManager_;
+    std::atomic<bool> running_{false};
+    std::weak_ptr<UdpCallback> udpCallback_;
+    std::mutex subscriptionMutex_;  // 只串行化订阅和取消订阅
+    // 写时复制，以 std::atomic_load/atomic_store 读写，收包线程只持有快照
+    std::shared_ptr<const SubscriptionList> subscriptions_;
+};
+
+}  // namespace aoip
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+
+namespace aoip
+{
+
+// Jacobson/Karels 往返时延估计（RFC 6298）
+// 按端点维护 SRTT/RTTVAR，超时后指数退避，收到有效样本后恢复
+// 非线程安全，由 RequestManager 加锁后使用
+class RttEstimator
+{
+   public:
+    RttEstimator(uint32_t initialTimeoutMs, uint32_t minTimeoutMs, uint32_t maxTimeoutMs);
+
+    // 只应传入未重传请求的样本（Karn 算法），否则无法区分是哪次发送的响应
+    void OnSample(double rttMs);
+    void OnTimeout();
+    // 当前重传超时（含退避），已限制在 [minTimeoutMs, maxTimeoutMs]
+    uint32_t GetTimeoutMs() const;
+
+    double GetSmoothedRttMs() const { return srttMs_; }
+    double GetRttVarMs() const { return rttVarMs_; }
+
+   private:
+    static constexpr uint32_t MAX_BACKOFF = 64;
+
+    uint32_t minTimeoutMs_;
+    uint32_t maxTimeoutMs_;
+    bool hasSample_{false};
+    double srttMs_{0};
+    double rttVarMs_{0};
+    double rtoMs_;
+    uint32_t backoff_{1};
+};
+
+}  // namespace aoip
@@ -3,8 +3,16 @@
 #include <Poco/Thread.h>
 #include <Poco/Runnable.h>
 #include <Poco/Logger.h>
+#include <chrono>
+#include <deque>
+#include <future>
+#include <mutex>
 #include <vector>
 #include <memory>
+#include "BufferPool.h"
+#include "RequestEngine.h"
+#include "StreamFramer.h"
+#include "TransportRuntime.h"
 
 namespace aoip
 {
@@ -13,35 +21,80 @@ class ResponseCallback
 {
 public:
     virtual ~ResponseCallback() = default;
-    virtual void OnRecvResponse(const std::vector<uint8_t>& data) = 0;
+    // data 引用缓冲池中的帧，需要保留时拷贝 FrameBuffer 即可，无需复制数据
+    // 未匹配任何在途请求的帧（直接 Write 的请求的响应、设备上报）经此回调
+    virtual void OnRecvResponse(const FrameBuffer& data) = 0;
 };
 
-class SerialTask : public Poco::Runnable
+// 串口链路：字节流经 StreamFramer 分帧后交给 RequestEngine，请求处理与 UDP 相同
+class SerialTask : public Poco::Runnable, private Transport
 {
 public:
-    SerialTask(std::shared_ptr<ResponseCallback> cb, const std::string& port, uint32_t baudRate, uint32_t readTimeoutMs);
+    // 写队列中未发出的字节上限，超出时 Write 返回 false
+    static constexpr size_t MAX_PENDING_WRITE_BYTES = 64 * 1024;
+
+    // config 为 SendRequest 的超时、重传和节流参数
+    SerialTask(std::shared_ptr<ResponseCallback> cb, const std::string& port, uint32_t baudRate, uint32_t readTimeoutSecond,
+               const RequestConfig& config = RequestConfig());
     ~SerialTask();
     virtual void run() override;
 
     void Start();
     void Stop();
 
-    void Write(const void* data, uint32_t len);
+    // 写入发送队列后立即返回，按入队顺序异步发出；串口未打开或队列已满时返回 false
+    bool Write(const void* data, uint32_t len);
+
+    // 与 UDP 相同按 (功能号, 序列号) 关联响应，多个请求可同时在途，超时按自适应 RTO 重传
+    std::future<FrameBuffer> SendRequest(uint16_t functionCode, uint32_t sequence, const void* data, size_t len,
+                                         RequestPriority priority = RequestPriority::NORMAL);
+    void SendRequest(uint16_t functionCode, uint32_t sequence, const void* data, size_t len, ResponseHandler handler,
+                     RequestPriority priority = RequestPriority::NORMAL);
+    // 解析响应关联键，未设置时 SendRequest 的请求只能超时结束
+    void SetCorrelationCallback(std::shared_ptr<UdpCallback> cb);
+    PacerMetrics GetPacerMetrics() const { return engine_->GetPacerMetrics(); }
 
 private:
-    void handleRead(const boost::system::error_code& ec, std::size_t bytesRead, std::vector<uint8_t>& buffer);
+    using WorkGuard = boost::asio::executor_work_guard<boost::asio::io_context::executor_type>;
+
+    // 有数据即返回的读取，读到的字节交给分帧器，完整帧到达后立即回调并接着发起下一次读取
+    void StartRead();
+    void handleRead(const boost::system::error_code& ec, std::size_t bytesRead);
+    void ArmIdleTimer();
     void handleTimeout(const boost::system::error_code& ec);
+    // 在 io_ 线程取出队列中的全部帧，合并为一次 async_write
+    void StartWrite();
+    void handleWrite(const boost::system::error_code& ec);
+    bool Enqueue(const FrameBuffer& frame);
+    // Transport：发送即入写队列；Sync 等待 io_ 线程上正在执行的收包回调
+    bool Transmit(const FrameBuffer& frame) override { return Enqueue(frame); }
+    void Sync() override;
 
     std::weak_ptr<ResponseCallback> cb_;
     std::atomic<bool> running_;
-    std::atomic<bool> readingInProgress_;  // 是否存在读取任务
-    std::atomic<bool> writingInProgress_;  // 是否存在写任务
-    boost::asio::io_service io_;
+    // Sync 在锁内检查 running_ 并投递，Stop 在锁内清除 running_：投递的任务总能在 io_ 退出前执行
+    std::mutex syncMutex_;
+    bool readingInProgress_;  // 是否存在读取任务，只在 io_ 线程访问
+    // 读写和定时器都在 run 线程的 io_ 上，读取完成后直接续读，空闲时阻塞在 epoll 中不占 CPU
+    boost::asio::io_context io_;
+    std::unique_ptr<WorkGuard> work_;
     boost::asio::serial_port serial_;
     boost::asio::steady_timer timeoutTimer_;
-    uint32_t readTimeoutSecond_; //读取超时时间 单位s
+    uint32_t readTimeoutSecond_; //读取超时时间 单位s，超时无数据时丢弃残留的半帧
+    std::chrono::steady_clock::time_point lastReadTime_;
+    StreamFramer framer_;
+
+    std::mutex writeMutex_;
+    std::deque<FrameBuffer> writeQueue_;  // 等待发送的帧
+    size_t pendingWriteBytes_{0};         // 已入队未发完的字节数，包括正在发送的
+    bool writingInProgress_{false};       // 是否存在写任务
+    std::vector<FrameBuffer> sending_;    // 正在发送的帧，只在 io_ 线程访问
+
+    // 超时定时器运行在传输运行时的 I/O 线程，节流窗口即串口上的最大在途请求数
+    std::unique_ptr<RequestEngine> engine_;
+    std::atomic<bool> correlated_{false};
     Poco::Thread thread_;
     Poco::Logger& logger_;
 };
 
-}
\ No newline at end of file
+}
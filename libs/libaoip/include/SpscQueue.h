@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace aoip
+{
+
+// 有界单生产者单消费者无锁队列，容量向上取整为 2 的幂
+// TryPush 只能在一个线程调用，TryPop 只能在另一个（或同一个）线程调用
+template <typename T>
+class SpscQueue
+{
+   public:
+    explicit SpscQueue(size_t capacity)
+    {
+        size_t size = 1;
+        while (size < capacity)
+        {
+            size <<= 1;
+        }
+        slots_.resize(size);
+        mask_ = size - 1;
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    size_t Capacity() const { return slots_.size(); }
+
+    // 队列已满时返回 false
+    bool TryPush(T value)
+    {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) >= slots_.size())
+        {
+            return false;
+        }
+        slots_[tail & mask_] = std::move(value);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 队列为空时返回 false；取出后槽位重置，及时释放元素持有的资源
+    bool TryPop(T& value)
+    {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        T& slot = slots_[head & mask_];
+        value = std::move(slot);
+        slot = T();
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 近似值，仅用于统计
+    size_t Size() const { return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire); }
+
+   private:
+    static constexpr size_t CACHE_LINE = 64;
+
+    std::vector<T> slots_;
+    size_t mask_{0};
+    alignas(CACHE_LINE) std::atomic<size_t> head_{0};  // 消费者位置
+    alignas(CACHE_LINE) std::atomic<size_t> tail_{0};  // 生产者位置
+};
+
+}  // namespace aoip
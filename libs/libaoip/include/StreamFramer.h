@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+#include "BufferPool.h"
+
+namespace aoip
+{
+
+// 字节流分帧格式：帧头魔数 + 头部其余字段 + 长度字段(u32) + 数据 + 尾部(校验和)，多字节字段均为小端
+// 默认值为 Kingray 协议帧：0x5A1AA1A5 | productID | deviceID | functionCode | dataLen(字) | data | checksum
+struct FramerConfig
+{
+    uint32_t magic_{0x5A1AA1A5};
+    size_t headerSize_{12};   // 长度字段在帧内的偏移，即魔数和其余头部字段的总长度
+    size_t lengthUnit_{4};    // 长度字段的单位（字节）
+    size_t trailerSize_{4};   // 数据之后的校验和长度
+    size_t maxFrameSize_{BufferPool::FRAME_SIZE};  // 超过该长度视为长度字段错误，按垃圾数据重新同步
+};
+
+// 增量分帧器：串口等字节流读到多少交多少，最后一个字节到达即切出完整帧
+// 帧头不匹配或长度非法时丢弃到下一个帧头重新同步；接收缓冲区为帧上限的两倍，只搬移未成帧的尾部
+// 非线程安全，应在读回调所在线程使用
+class StreamFramer
+{
+   public:
+    using FrameHandler = std::function<void(const FrameBuffer& frame)>;
+
+    explicit StreamFramer(const FramerConfig& config = FramerConfig());
+
+    StreamFramer(const StreamFramer&) = delete;
+    StreamFramer& operator=(const StreamFramer&) = delete;
+
+    // 可写入区域，直接作为 async_read_some 的缓冲区，读到数据后调用 Commit
+    uint8_t* WritePtr();
+    size_t Writable();
+
+    // 提交写入区域中新读到的 len 字节，每切出一帧回调一次，帧数据取自缓冲池
+    void Commit(size_t len, const FrameHandler& handler);
+    // 拷贝外部数据并分帧
+    void Feed(const uint8_t* data, size_t len, const FrameHandler& handler);
+
+    // 丢弃未成帧的数据，如读超时后丢弃残留的半帧；写入位置不变，读取进行中也可调用
+    void Reset();
+
+    size_t GetPending() const { return tail_ - head_; }
+    // 重新同步时丢弃的字节数
+    uint64_t GetDiscarded() const { return discarded_; }
+    uint64_t GetFrames() const { return frames_; }
+
+   private:
+    bool IsMagic(const uint8_t* data) const;
+    uint32_t ReadLength(const uint8_t* data) const;
+    // 从 head_ 之后查找下一个帧头，找不到时保留末尾可能是半个帧头的字节
+    void Resync();
+
+    FramerConfig config_;
+    uint8_t magicBytes_[sizeof(uint32_t)];
+    size_t capacity_;
+    std::unique_ptr<uint8_t[]> buffer_;
+    size_t head_{0};  // 未成帧数据的起始位置
+    size_t tail_{0};  // 已写入数据的结束位置
+    uint64_t discarded_{0};
+    uint64_t frames_{0};
+};
+
+}  // namespace aoip
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+namespace aoip
+{
+
+// 分层时间轮，刻度 1ms，4 层 x 64 槽，覆盖约 4.6 小时，超出部分按最大值处理
+// 非线程安全，由 Reactor 加锁后使用
+class TimerWheel
+{
+   public:
+    using Clock = std::chrono::steady_clock;
+    using TimerCallback = std::function<void()>;
+
+    explicit TimerWheel(Clock::time_point start = Clock::now());
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    // 添加定时器，返回定时器ID（从 1 开始）
+    uint64_t Schedule(Clock::time_point now, uint32_t delayMs, TimerCallback cb);
+    bool Cancel(uint64_t timerId);
+    // 推进时间轮到 now，到期的回调追加到 expired，由调用方在锁外执行
+    void Advance(Clock::time_point now, std::vector<TimerCallback>& expired);
+    // 距离下一次需要推进的毫秒数，-1 表示没有定时器
+    int NextTimeoutMs(Clock::time_point now) const;
+    size_t Size() const { return index_.size(); }
+
+   private:
+    static constexpr uint32_t WHEEL_BITS = 6;
+    static constexpr uint32_t WHEEL_SLOTS = 1u << WHEEL_BITS;
+    static constexpr uint32_t WHEEL_MASK = WHEEL_SLOTS - 1;
+    static constexpr uint32_t WHEEL_LEVELS = 4;
+    static constexpr uint64_t MAX_DELAY_TICKS = (1ull << (WHEEL_BITS * WHEEL_LEVELS)) - 1;
+
+    struct Timer
+    {
+        uint64_t id_;
+        uint64_t expireTick_;
+        TimerCallback cb_;
+    };
+    using Slot = std::list<Timer>;
+    struct Location
+    {
+        Slot* slot_;
+        Slot::iterator it_;
+    };
+
+    uint64_t ToTick(Clock::time_point now) const;
+    Slot& SlotFor(uint64_t expireTick);
+    void Place(Slot& from, Slot::iterator it);
+    void Cascade(uint32_t level);
+
+    Clock::time_point start_;
+    uint64_t currentTick_{0};  // 下一个待处理的刻度
+    uint64_t nextTimerId_{1};
+    std::array<std::array<Slot, WHEEL_SLOTS>, WHEEL_LEVELS> wheels_;
+    std::unordered_map<uint64_t, Location> index_;
+};
+
+}  // namespace aoip
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "Reactor.h"
+#include "UdpChannel.h"
+
+namespace aoip
+{
+
+// 进程级传输运行时：固定数量的 I/O 线程（Reactor），每个本地端口一个共享 UdpChannel
+// 设备控制器数量增加时不再增加线程和 socket
+class TransportRuntime
+{
+   public:
+    static constexpr size_t DEFAULT_IO_THREADS = 2;
+
+    static TransportRuntime& Instance()
+    {
+        static TransportRuntime instance;
+        return instance;
+    }
+
+    // pinThreads 为 true 时 I/O 线程依次绑定到各个 CPU 核
+    explicit TransportRuntime(size_t ioThreads = DEFAULT_IO_THREADS, bool pinThreads = false);
+    ~TransportRuntime();
+
+    TransportRuntime(const TransportRuntime&) = delete;
+    TransportRuntime& operator=(const TransportRuntime&) = delete;
+
+    // 获取绑定到 config 本地地址的共享通道，最后一个使用者释放后关闭 socket
+    // bindPort_ 为 0 时每次创建独立通道；指定 peer_ 的已连接通道按 (本地地址, 对端) 共享
+    // receiveShards_ 大于 1 时在不同 I/O 线程上各开一个 SO_REUSEPORT 接收 socket，分片数不超过 I/O 线程数
+    std::shared_ptr<UdpChannel> AcquireChannel(const UdpConfig& config);
+    // 按轮询分配 I/O 线程，供不经过 UdpChannel 的 fd 和定时任务使用
+    std::shared_ptr<Reactor> NextReactor();
+
+   private:
+    std::mutex mutex_;
+    std::vector<std::shared_ptr<Reactor>> reactors_;
+    size_t nextReactor_{0};
+    // <(绑定地址, 绑定端口, 对端键), 通道>
+    std::map<std::tuple<std::string, uint16_t, uint64_t>, std::weak_ptr<UdpChannel>> channels_;
+};
+
+}  // namespace aoip
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "EndpointPacer.h"
+#include "Reactor.h"
+#include "UdpSocket.h"
+
+namespace aoip
+{
+
+// 多个协议实例共享的 UDP 通道：一个本地端口一个 socket，
+// 在所属 Reactor 线程收包，并按源端点分发给订阅者
+// 给出多个 Reactor 时以 SO_REUSEPORT 在同一端口为每个 Reactor 打开一个接收 socket，
+// 内核按四元组哈希分流，同一设备的报文总在同一线程分发，接收吞吐随线程数扩展
+class UdpChannel
+{
+   public:
+    // 返回 true 表示报文已被消费，不再交给同端点的其他订阅者；分片接收时可能在任一接收线程回调
+    using Sink = std::function<bool(const FrameBuffer& data, uint32_t fromIp, uint16_t fromPort)>;
+
+    UdpChannel(const UdpConfig& config, std::shared_ptr<Reactor> reactor);
+    // 第一个 Reactor 的 socket 同时负责发送和组播成员关系，定时任务也在其上执行
+    UdpChannel(const UdpConfig& config, const std::vector<std::shared_ptr<Reactor>>& reactors);
+    ~UdpChannel();
+
+    UdpChannel(const UdpChannel&) = delete;
+    UdpChannel& operator=(const UdpChannel&) = delete;
+
+    // ip/port 为网络字节序，均为 0 时订阅所有未被端点订阅者消费的报文（广播场景）
+    uint64_t AddSink(uint32_t ip, uint16_t port, Sink sink);
+    // 移除后保证该订阅者不再被回调
+    void RemoveSink(uint64_t sinkId);
+
+    bool SendTo(const void* data, size_t len, const Endpoint& to);
+    bool Broadcast(const void* data, size_t len, uint16_t port);
+    // 一次系统调用发往多个端点，返回成功发送的个数
+    size_t SendBatch(const std::vector<Datagram>& datagrams);
+
+    // 加入/离开组播组，同一通道上的多个协议实例按引用计数共享成员关系，最后一个离开时才退出组
+    bool JoinGroup(const std::string& groupIp, const std::string& interfaceIp = "");
+    void LeaveGroup(const std::string& groupIp, const std::string& interfaceIp = "");
+
+    // 获取端点（网络字节序）的发送节流器，同一端点的协议实例共享，config 以首次创建时为准
+    std::shared_ptr<EndpointPacer> GetPacer(uint32_t ip, uint16_t port, const PacerConfig& config);
+
+    const std::shared_ptr<Reactor>& GetReactor() const { return reactor_; }
+    size_t GetShardCount() const { return receivers_.size(); }
+    // 等待所有接收线程上正在进行的分发结束
+    void Sync();
+
+   private:
+    struct SinkEntry
+    {
+        uint64_t id_;
+        uint64_t endpoint_;
+        Sink sink_;
+    };
+    using SinkList = std::vector<std::shared_ptr<const SinkEntry>>;
+    // 写时复制，收包线程只持有快照，不在锁内回调
+    using SinkTable = std::unordered_map<uint64_t, SinkList>;
+
+    struct Receiver
+    {
+        std::shared_ptr<Reactor> reactor_;
+        std::unique_ptr<UdpSocket> socket_;
+        std::unique_ptr<DatagramRing> ring_;
+    };
+
+    void OnReadable(Receiver& receiver);
+    void Dispatch(const SinkTable& table, const FrameBuffer& frame, uint32_t fromIp, uint16_t fromPort);
+
+    static constexpr size_t RECV_BATCH_SIZE = 32;  // 单次 recvmmsg 最多接收的报文数
+    static constexpr int MAX_BATCH_PER_EVENT = 4;  // 单次可读事件最多的 recvmmsg 次数
+
+    std::shared_ptr<Reactor> reactor_;
+    std::vector<Receiver> receivers_;
+    UdpSocket* socket_{nullptr};  // 发送用的 socket，即第一个接收 socket
+
+    std::mutex sinkMutex_;
+    uint64_t nextSinkId_{1};
+    std::shared_ptr<const SinkTable> sinks_;
+
+    std::mutex groupMutex_;
+    std::map<std::pair<std::string, std::string>, uint32_t> groups_;  // <(组地址, 接口地址), 引用计数>
+
+    std::mutex pacerMutex_;
+    std::unordered_map<uint64_t, std::weak_ptr<EndpointPacer>> pacers_;
+};
+
+}  // namespace aoip
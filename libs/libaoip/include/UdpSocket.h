@@ -1,11 +1,38 @@
 #pragma once
+#include <netinet/in.h>
+#include <sys/socket.h>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
+#include "BufferPool.h"
 
 namespace aoip
 {
 
+// 预解析的 IPv4 端点，ip_/port_ 为网络字节序；解析只在创建时做一次，收发和比较都是整数操作
+struct Endpoint
+{
+    uint32_t ip_{0};
+    uint16_t port_{0};
+
+    Endpoint() = default;
+    Endpoint(uint32_t ip, uint16_t port) : ip_(ip), port_(port) {}
+
+    // ip 为点分十进制字符串，port 为主机字节序
+    static Endpoint Resolve(const std::string& ip, uint16_t port);
+
+    bool IsValid() const { return ip_ != 0 && port_ != 0; }
+    // 按 (ip, port) 组合的整数键，用于哈希表
+    uint64_t Key() const { return (static_cast<uint64_t>(ip_) << 16) | port_; }
+    struct sockaddr_in ToSockaddr() const;
+    // 仅用于日志
+    std::string ToString() const;
+
+    bool operator==(const Endpoint& other) const { return ip_ == other.ip_ && port_ == other.port_; }
+    bool operator!=(const Endpoint& other) const { return !(*this == other); }
+};
+
 struct UdpConfig
 {
     std::string bindIp_{"0.0.0.0"};
@@ -13,7 +40,55 @@ struct UdpConfig
     bool broadcast_{false};
     size_t sendBufferSize_{65535};
     size_t recvBufferSize_{65535};
+    size_t maxDatagramSize_{2048};  // 单个数据报接收缓冲大小，超出部分被截断丢弃
     int timeoutMs_{1000};
+    std::string multicastInterface_;  // 组播收发使用的本地接口地址，为空时由系统按路由选择
+    uint8_t multicastTtl_{1};         // 组播 TTL，默认不出本网段
+    bool multicastLoopback_{false};   // 本机发出的组播是否回环给本机的组成员
+    bool reusePort_{false};           // SO_REUSEPORT，多个 socket 绑定同一端口由内核分流
+    size_t receiveShards_{1};         // UdpChannel 的接收分片数，由 TransportRuntime 分配到不同 I/O 线程；
+                                      // 单播按四元组固定到一个分片，广播报文每个分片各收一份，
+                                      // 组播只由加入组的第一个分片接收（IP_MULTICAST_ALL=0）
+    // 有效时 connect 到该端点：发往它的数据报免去每次的路由查找，且只接收它发来的数据报
+    Endpoint peer_;
+};
+
+// 批量收发的数据报描述，ip_/port_ 为网络字节序
+struct Datagram
+{
+    const void* data_{nullptr};
+    size_t len_{0};
+    uint32_t ip_{0};
+    uint16_t port_{0};
+};
+
+// 接收缓冲：capacity 个槽位各持有一个缓冲池帧，recvmmsg 直接写入帧内
+// Take 取走的帧在下次 RecvBatch 前从缓冲池补齐，数据报从 socket 到调用方全程不复制
+class DatagramRing
+{
+   public:
+    DatagramRing(size_t capacity, size_t datagramSize);
+
+    DatagramRing(const DatagramRing&) = delete;
+    DatagramRing& operator=(const DatagramRing&) = delete;
+
+    size_t Capacity() const { return headers_.size(); }
+    // 最近一次 RecvBatch 收到的数据报个数
+    size_t Size() const { return size_; }
+    Datagram operator[](size_t index) const;
+    // 取走第 index 个数据报所在的帧，被截断的数据报返回空帧
+    FrameBuffer Take(size_t index);
+
+   private:
+    friend class UdpSocket;
+    void Refill();
+
+    size_t datagramSize_;
+    size_t size_{0};
+    std::vector<FrameBuffer> frames_;
+    std::vector<struct iovec> iovecs_;
+    std::vector<struct sockaddr_in> addrs_;
+    std::vector<struct mmsghdr> headers_;
 };
 
 class UdpSocket
@@ -25,7 +100,13 @@ class UdpSocket
     UdpSocket(const UdpSocket&) = delete;
     UdpSocket& operator=(const UdpSocket&) = delete;
 
-    bool SendTo(const void* data, size_t len, const std::string& ip, uint16_t port);
+    // 已连接且发往 peer_ 时使用 send，否则 sendto
+    bool SendTo(const void* data, size_t len, const Endpoint& to);
+
+    bool SendTo(const void* data, size_t len, const std::string& ip, uint16_t port)
+    {
+        return SendTo(data, len, Endpoint::Resolve(ip, port));
+    }
 
     bool SendTo(const std::vector<uint8_t>& data, const std::string& ip, uint16_t port)
     {
@@ -39,20 +120,41 @@ class UdpSocket
         return Broadcast(data.data(), data.size(), port);
     }
 
+    // 加入/离开组播组（IGMP），interfaceIp 为空时使用 multicastInterface_；
+    // 加入后发往 groupIp:bindPort_ 的数据报由本 socket 接收，发送组播直接 SendTo 组地址即可
+    bool JoinGroup(const std::string& groupIp, const std::string& interfaceIp = "");
+    bool LeaveGroup(const std::string& groupIp, const std::string& interfaceIp = "");
+
+    bool RecvFrom(void* buffer, size_t& len, Endpoint& from, int timeoutMs = -1);
+
     bool RecvFrom(void* buffer, size_t& len, std::string& fromIp, uint16_t& fromPort, int timeoutMs = -1);
 
     bool RecvFrom(std::vector<uint8_t>& data, std::string& fromIp, uint16_t& fromPort, int timeoutMs = -1);
 
-    std::string GetLastError() const { return lastError_; }
+    // sendmmsg 批量发送，返回成功发送的个数
+    size_t SendBatch(const Datagram* datagrams, size_t count);
+    // recvmmsg 非阻塞批量接收到 ring，返回接收个数，无数据时返回 0
+    size_t RecvBatch(DatagramRing& ring);
+
+    std::string GetLastError() const;
+    int GetFd() const { return socket_; }
+    bool IsConnected() const { return connected_; }
+    // 非阻塞模式下无数据时 RecvFrom 直接返回 false，供事件循环使用
+    bool SetNonBlocking(bool nonBlocking);
     bool GetLocalAddress(std::string& ip, uint16_t& port) const;
 
    private:
     bool Init();
     bool SetSocketOptions();
+    bool SetMulticastOptions();
+    bool UpdateMembership(int option, const std::string& groupIp, const std::string& interfaceIp);
     void SetError(const char* msg);
 
     int socket_{-1};
+    bool connected_{false};
     UdpConfig config_;
+    // 共享的 socket 可能在多个发送线程和接收线程同时出错
+    mutable std::mutex errorMutex_;
     std::string lastError_;
 };
 
@@ -1,3 +1,5 @@
+#include <arpa/inet.h>
+#include <map>
 #include "AsyncProtocol.h"
 #include "Logger.h"
 #include "code/ErrorCode.h"
@@ -5,183 +7,183 @@
 namespace aoip
 {
 
-uint32_t RequestManager::AddRequest(std::shared_ptr<Request> request)
-{
-    std::lock_guard<std::mutex> lock(mutex_);
-    uint32_t requestId = nextRequestId_++;
-    requests_[requestId] = request;
-    return requestId;
-}
-
-bool RequestManager::MatchResponse(const std::vector<uint8_t>& response)
+AsyncProtocol::AsyncProtocol(const ProtocolConfig& config, TransportRuntime& runtime)
+    : config_(config),
+      master_(config.broadcast_ ? Endpoint(INADDR_BROADCAST, htons(config.masterPort_))
+                                : Endpoint::Resolve(config.masterIp_, config.masterPort_)),
+      group_(config.multicastIp_.empty() ? Endpoint() : Endpoint::Resolve(config.multicastIp_, config.multicastPort_)),
+      channel_(runtime.AcquireChannel(MakeUDPConfig(config)))
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    std::string recvFunctionCode;
-    if (udpCallback_.lock())
+    // 通配端点收到任意设备的帧，多分片时会从多个接收线程同时回调，而事件队列只允许单生产者
+    if (config.broadcast_ && channel_->GetShardCount() > 1)
     {
-        recvFunctionCode = udpCallback_.lock()->GetFunctionCode(response);
+        RUNTIME_EXCEPTION("Broadcast protocol requires a single receive shard, port=" << config.slavePort_);
     }
-    else
+    // 广播请求的响应来源不确定，以通配端点关联
+    const Endpoint peer = config.broadcast_ ? Endpoint() : master_;
+    // 广播不经 pacer：各广播实例的对端同为通配端点，共用一个 pacer 会互相节流；不限速时也不必排队
+    std::shared_ptr<EndpointPacer> pacer;
+    if (!config.broadcast_ && !config.pacer_.Unlimited())
     {
-        AOIP_LOG_ERROR("udp callback is null!");
-        return false;
+        pacer = channel_->GetPacer(peer.ip_, peer.port_, config.pacer_);
     }
+    engine_ = std::make_unique<RequestEngine>(channel_->GetReactor(), config, static_cast<Transport&>(*this), peer, pacer);
+}
+
+AsyncProtocol::~AsyncProtocol() { Stop(); }
 
-    for (auto it = requests_.begin(); it != requests_.end(); ++it)
+void AsyncProtocol::Start()
+{
+    if (engine_->IsRunning()) return;
+
+    // 广播请求的响应来源不确定，以通配方式订阅
+    const uint32_t ip = config_.broadcast_ ? 0 : master_.ip_;
+    const uint16_t port = config_.broadcast_ ? 0 : master_.port_;
+    sinkId_ = channel_->AddSink(ip, port, [this](const FrameBuffer& data, uint32_t fromIp, uint16_t fromPort) {
+        return engine_->OnReceive(data, fromIp, fromPort);
+    });
+    if (!config_.multicastIp_.empty())
     {
-        if (it->second->functionCode_ == recvFunctionCode)
+        joinedGroup_ = channel_->JoinGroup(config_.multicastIp_, config_.multicastInterface_);
+        if (!joinedGroup_)
         {
-            it->second->promise_.set_value(response);
-            requests_.erase(it);
-            return true;
+            AOIP_LOG_WARN("Failed to join multicast group " << config_.multicastIp_);
         }
     }
-    return false;
+    engine_->Start();
 }
 
-void RequestManager::CleanTimeouts()
+void AsyncProtocol::Stop()
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto now = std::chrono::steady_clock::now();
+    if (!engine_->IsRunning()) return;
 
-    for (auto it = requests_.begin(); it != requests_.end();)
+    if (joinedGroup_)
     {
-        auto& request = it->second;
-        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - request->timestamp_).count();
-
-        if (elapsed > request->timeoutMs_)
-        {
-            request->promise_.set_exception(std::make_exception_ptr(std::runtime_error("Request timeout")));
-            it = requests_.erase(it);
-        }
-        else
-        {
-            ++it;
-        }
+        channel_->LeaveGroup(config_.multicastIp_, config_.multicastInterface_);
+        joinedGroup_ = false;
     }
+    channel_->RemoveSink(sinkId_);
+    engine_->Stop("Protocol stopped");
 }
 
-void RequestManager::SetUdpCallback(std::shared_ptr<UdpCallback> cb)
+std::future<FrameBuffer> AsyncProtocol::SendRequest(uint16_t functionCode, const void* data, size_t len)
 {
-    udpCallback_ = cb;
+    return engine_->SendRequest(functionCode, data, len);
 }
 
-AsyncProtocol::AsyncProtocol(const ProtocolConfig& config)
-    : config_(config),
-      socket_(std::make_unique<UdpSocket>(MakeUDPConfig(config))),
-      requestManager_(std::make_unique<RequestManager>())
+std::future<FrameBuffer> AsyncProtocol::SendRequest(uint16_t functionCode, uint32_t sequence, const void* data, size_t len,
+                                                    RequestPriority priority)
 {
+    return engine_->SendRequest(functionCode, sequence, data, len, priority);
 }
 
-AsyncProtocol::~AsyncProtocol() { Stop(); }
-
-void AsyncProtocol::Start()
+void AsyncProtocol::SendRequest(uint16_t functionCode, uint32_t sequence, const void* data, size_t len, ResponseHandler handler,
+                                RequestPriority priority)
 {
-    if (running_) return;
-
-    running_ = true;
-    receiverThread_ = std::thread(&AsyncProtocol::ReceiverLoop, this);
-    timeoutThread_ = std::thread(&AsyncProtocol::TimeoutLoop, this);
+    engine_->SendRequest(functionCode, sequence, data, len, std::move(handler), priority);
 }
 
-void AsyncProtocol::Stop()
+bool AsyncProtocol::SendMulticast(const void* data, size_t len)
 {
-    if (!running_) return;
-
-    running_ = false;
-    if (receiverThread_.joinable())
-    {
-        receiverThread_.join();
-    }
-    if (timeoutThread_.joinable())
+    if (!group_.IsValid())
     {
-        timeoutThread_.join();
+        AOIP_LOG_ERROR("Multicast group not configured");
+        return false;
     }
+    return channel_->SendTo(data, len, group_);
 }
 
-std::future<std::vector<uint8_t>> AsyncProtocol::SendRequest(const std::string& functionCode, const void* data, size_t len)
+std::vector<std::future<FrameBuffer>> AsyncProtocol::SendRequests(const std::vector<BatchRequest>& requests)
 {
-    if (!running_)
+    std::vector<std::future<FrameBuffer>> futures;
+    futures.reserve(requests.size());
+    // 按共享通道分组，每个通道一次 sendmmsg
+    std::map<UdpChannel*, std::vector<Datagram>> batches;
+    for (const auto& item : requests)
     {
-        RUNTIME_EXCEPTION("Protocol not started");
+        AsyncProtocol* protocol = item.protocol_;
+        if (nullptr == protocol)
+        {
+            // 没有协议实例无法登记，只结束该项自身的 future 或回调
+            auto request = std::make_shared<Request>(item.functionCode_, 0);
+            request->handler_ = item.handler_;
+            futures.push_back(request->handler_ ? std::future<FrameBuffer>() : request->promise_.get_future());
+            request->Fail(std::make_exception_ptr(std::runtime_error("Batch request without protocol")));
+            continue;
+        }
+        auto request = protocol->engine_->MakeRequest(item.functionCode_, item.sequence_, item.priority_);
+        request->handler_ = item.handler_;
+        futures.push_back(request->handler_ ? std::future<FrameBuffer>() : request->promise_.get_future());
+        if (protocol->engine_->Register(request, item.data_, item.len_))
+        {
+            batches[protocol->channel_.get()].push_back(protocol->MakeDatagram(item.data_, item.len_));
+        }
     }
 
-    auto request = std::make_shared<Request>(functionCode, config_.timeoutMs_);
-    auto requestId = requestManager_->AddRequest(request);
-
-    if (config_.broadcast_)
+    for (auto& batch : batches)
     {
-        socket_->Broadcast(data, len, config_.masterPort_);
-    } 
-    else
-    {
-        socket_->SendTo(data, len, config_.masterIp_, config_.masterPort_);
+        // 未发出的请求由超时重传补发
+        batch.first->SendBatch(batch.second);
     }
+    return futures;
+}
+
+Datagram AsyncProtocol::MakeDatagram(const void* data, size_t len) const
+{
+    Datagram datagram;
+    datagram.data_ = data;
+    datagram.len_ = len;
+    datagram.ip_ = master_.ip_;
+    datagram.port_ = master_.port_;
+    return datagram;
+}
 
-    AOIP_LOG_DEBUG("Sent request: " << request->functionCode_);
+bool AsyncProtocol::Transmit(const FrameBuffer& frame)
+{
+    return channel_->SendTo(frame.data(), frame.size(), master_);
+}
 
-    return request->promise_.get_future();
+void AsyncProtocol::Sync()
+{
+    channel_->Sync();
 }
 
 void AsyncProtocol::SetUdpCallback(std::shared_ptr<UdpCallback> cb)
 {
-    if (requestManager_)
-    {
-        requestManager_->SetUdpCallback(cb);
-    }
+    engine_->SetCorrelationCallback(cb);
 }
 
-void AsyncProtocol::ReceiverLoop()
+std::shared_ptr<EventSubscription> AsyncProtocol::Subscribe(uint32_t functionCode, uint64_t sequence, size_t capacity,
+                                                            EventSubscription::Notifier notifier)
 {
-    std::vector<uint8_t> buffer;
-    std::string fromIp;
-    uint16_t fromPort;
-
-    while (running_)
+    // 设备的广播帧会到达每个分片，同一订阅会被多个接收线程写入
+    if (channel_->GetShardCount() > 1)
     {
-        try {
-            if (!socket_->RecvFrom(buffer, fromIp, fromPort))
-            {
-                continue;
-            }
-
-            AOIP_LOG_DEBUG("Received response: ");
-
-            if (!requestManager_->MatchResponse(buffer))
-            {
-                AOIP_LOG_WARN("Unmatched response received");
-            }
-
-        }
-        catch (const std::exception& e)
-        {
-            AOIP_LOG_ERROR("Error in receiver loop: " << e.what());
-        }
+        RUNTIME_EXCEPTION("Event subscription requires a single receive shard, port=" << config_.slavePort_);
     }
+    return engine_->Subscribe(functionCode, sequence, capacity, std::move(notifier));
 }
 
-void AsyncProtocol::TimeoutLoop() {
-    while (running_)
-    {
-        try
-        {
-            requestManager_->CleanTimeouts();
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
-        }
-        catch (const std::exception& e)
-        {
-            AOIP_LOG_ERROR("Error in timeout loop: " << e.what());
-        }
-    }
+void AsyncProtocol::Unsubscribe(const std::shared_ptr<EventSubscription>& subscription)
+{
+    engine_->Unsubscribe(subscription);
 }
 
 UdpConfig AsyncProtocol::MakeUDPConfig(const ProtocolConfig& config)
 {
     UdpConfig udpConfig;
-    udpConfig.bindIp_ = config.masterIp_;
-    udpConfig.bindPort_ = config.masterPort_;
+    // 本机在 slavePort_ 上收发，masterIp_/masterPort_ 是对端设备地址
+    udpConfig.bindIp_ = "0.0.0.0";
+    udpConfig.bindPort_ = config.slavePort_;
     udpConfig.broadcast_ = config.broadcast_;
     udpConfig.timeoutMs_ = config.timeoutMs_;
+    udpConfig.multicastInterface_ = config.multicastInterface_;
+    udpConfig.multicastTtl_ = config.multicastTtl_;
+    udpConfig.receiveShards_ = config.receiveShards_;
+    if (config.connected_ && !config.broadcast_)
+    {
+        udpConfig.peer_ = Endpoint::Resolve(config.masterIp_, config.masterPort_);
+    }
     return udpConfig;
 }
 
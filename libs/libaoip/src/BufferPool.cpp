@@ -0,0 +1,159 @@
+#include <algorithm>
+#include <sstream>
+#include "BufferPool.h"
+#include "code/ErrorCode.h"
+
+namespace aoip
+{
+
+FrameBuffer::FrameBuffer(Frame* frame, size_t size)
+    : frame_(frame),
+      size_(size)
+{
+    frame_->refs_.fetch_add(1, std::memory_order_relaxed);
+}
+
+FrameBuffer::FrameBuffer(const FrameBuffer& other)
+    : frame_(other.frame_),
+      offset_(other.offset_),
+      size_(other.size_)
+{
+    if (frame_)
+    {
+        frame_->refs_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+FrameBuffer::FrameBuffer(FrameBuffer&& other) noexcept
+    : frame_(other.frame_),
+      offset_(other.offset_),
+      size_(other.size_)
+{
+    other.frame_ = nullptr;
+    other.offset_ = 0;
+    other.size_ = 0;
+}
+
+FrameBuffer& FrameBuffer::operator=(const FrameBuffer& other)
+{
+    if (this != &other)
+    {
+        FrameBuffer copy(other);
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+FrameBuffer& FrameBuffer::operator=(FrameBuffer&& other) noexcept
+{
+    if (this != &other)
+    {
+        Reset();
+        frame_ = other.frame_;
+        offset_ = other.offset_;
+        size_ = other.size_;
+        other.frame_ = nullptr;
+        other.offset_ = 0;
+        other.size_ = 0;
+    }
+    return *this;
+}
+
+FrameBuffer::~FrameBuffer() { Reset(); }
+
+void FrameBuffer::Reset()
+{
+    if (frame_ && frame_->refs_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        if (frame_->pool_)
+        {
+            frame_->pool_->Release(frame_);
+        }
+        else
+        {
+            delete[] frame_->data_;
+            delete frame_;
+        }
+    }
+    frame_ = nullptr;
+    offset_ = 0;
+    size_ = 0;
+}
+
+const uint8_t* FrameBuffer::data() const { return frame_ ? frame_->data_ + offset_ : nullptr; }
+
+uint8_t* FrameBuffer::MutableData() { return frame_ ? frame_->data_ + offset_ : nullptr; }
+
+size_t FrameBuffer::Capacity() const { return frame_ ? frame_->capacity_ - offset_ : 0; }
+
+void FrameBuffer::Resize(size_t size)
+{
+    if (size > Capacity())
+    {
+        RUNTIME_EXCEPTION("frame buffer resize overflow, size=" << size << ", capacity=" << Capacity());
+    }
+    size_ = size;
+}
+
+FrameBuffer FrameBuffer::Slice(size_t offset, size_t len) const
+{
+    if (offset + len > size_)
+    {
+        RUNTIME_EXCEPTION("frame buffer slice out of range, offset=" << offset << ", len=" << len << ", size=" << size_);
+    }
+    FrameBuffer slice(*this);
+    slice.offset_ += offset;
+    slice.size_ = len;
+    return slice;
+}
+
+BufferPool::BufferPool(size_t frameCount, size_t frameSize)
+    : frameSize_(frameSize),
+      slab_(new uint8_t[frameCount * frameSize]),
+      frames_(new FrameBuffer::Frame[frameCount])
+{
+    freeList_.reserve(frameCount);
+    for (size_t i = 0; i < frameCount; ++i)
+    {
+        FrameBuffer::Frame& frame = frames_[i];
+        frame.pool_ = this;
+        frame.data_ = slab_.get() + i * frameSize_;
+        frame.capacity_ = frameSize_;
+        freeList_.push_back(&frame);
+    }
+}
+
+BufferPool::~BufferPool() = default;
+
+FrameBuffer BufferPool::Acquire(size_t size)
+{
+    if (size <= frameSize_)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!freeList_.empty())
+        {
+            FrameBuffer::Frame* frame = freeList_.back();
+            freeList_.pop_back();
+            return FrameBuffer(frame, size);
+        }
+    }
+
+    auto* frame = new FrameBuffer::Frame();
+    frame->capacity_ = std::max(size, frameSize_);
+    frame->data_ = new uint8_t[frame->capacity_];
+    return FrameBuffer(frame, size);
+}
+
+size_t BufferPool::Available() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return freeList_.size();
+}
+
+void BufferPool::Release(FrameBuffer::Frame* frame)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    freeList_.push_back(frame);
+}
+
+}  // namespace aoip
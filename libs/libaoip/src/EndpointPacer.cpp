@@ -0,0 +1,221 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "EndpointPacer.h"
+#include "Logger.h"
+
+namespace aoip
+{
+
+EndpointPacer::EndpointPacer(const PacerConfig& config, std::shared_ptr<Reactor> reactor)
+    : config_(config),
+      reactor_(reactor),
+      tokens_(std::max<uint32_t>(config.burst_, 1)),
+      lastRefill_(Clock::now())
+{
+}
+
+bool EndpointPacer::Admit(const void* owner, RequestPriority priority, Task task)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto now = Clock::now();
+    // 不能越过同级或更高优先级的排队请求，可以越过低优先级的
+    if (!HasPendingAtOrAbove(priority) && TryTake(now, priority))
+    {
+        return true;
+    }
+
+    pending_[static_cast<size_t>(priority)].push_back(PendingTask{owner, std::move(task)});
+    ++throttled_;
+    ScheduleDrain();
+    return false;
+}
+
+void EndpointPacer::Release()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (inFlight_ > 0)
+        {
+            --inFlight_;
+        }
+        if (PendingCount() == 0)
+        {
+            return;
+        }
+    }
+    Drain();
+}
+
+size_t EndpointPacer::Cancel(const void* owner)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    const size_t before = PendingCount();
+    for (auto& queue : pending_)
+    {
+        queue.erase(std::remove_if(queue.begin(), queue.end(),
+                                   [owner](const PendingTask& pending) { return pending.owner_ == owner; }),
+                    queue.end());
+    }
+    const size_t removed = before - PendingCount();
+    // 其他 owner 释放窗口时可能已把该 owner 的任务取出，正在锁外执行
+    runningDone_.wait(lock, [this, owner]() { return std::find(running_.begin(), running_.end(), owner) == running_.end(); });
+    return removed;
+}
+
+PacerMetrics EndpointPacer::GetMetrics() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    PacerMetrics metrics;
+    for (size_t i = 0; i < PRIORITY_COUNT; ++i)
+    {
+        metrics.pendingByPriority_[i] = pending_[i].size();
+        metrics.pending_ += pending_[i].size();
+    }
+    metrics.inFlight_ = inFlight_;
+    metrics.admitted_ = admitted_;
+    metrics.throttled_ = throttled_;
+    return metrics;
+}
+
+void EndpointPacer::Refill(Clock::time_point now)
+{
+    if (config_.ratePerSecond_ == 0)
+    {
+        return;
+    }
+    const double elapsed = std::chrono::duration<double>(now - lastRefill_).count();
+    tokens_ = std::min<double>(std::max<uint32_t>(config_.burst_, 1), tokens_ + elapsed * config_.ratePerSecond_);
+    lastRefill_ = now;
+}
+
+bool EndpointPacer::HasPendingAtOrAbove(RequestPriority priority) const
+{
+    for (size_t i = 0; i <= static_cast<size_t>(priority); ++i)
+    {
+        if (!pending_[i].empty())
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t EndpointPacer::PendingCount() const
+{
+    size_t count = 0;
+    for (const auto& queue : pending_)
+    {
+        count += queue.size();
+    }
+    return count;
+}
+
+uint32_t EndpointPacer::WindowFor(RequestPriority priority) const
+{
+    if (priority == RequestPriority::BACKGROUND && config_.maxInFlight_ > 1)
+    {
+        return config_.maxInFlight_ - 1;
+    }
+    return config_.maxInFlight_;
+}
+
+bool EndpointPacer::TryTake(Clock::time_point now, RequestPriority priority)
+{
+    if (config_.maxInFlight_ != 0 && inFlight_ >= WindowFor(priority))
+    {
+        return false;
+    }
+
+    Refill(now);
+    if (config_.ratePerSecond_ != 0)
+    {
+        if (tokens_ < 1)
+        {
+            return false;
+        }
+        tokens_ -= 1;
+    }
+
+    ++inFlight_;
+    ++admitted_;
+    return true;
+}
+
+void EndpointPacer::Drain()
+{
+    std::vector<PendingTask> ready;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto now = Clock::now();
+        // 从高到低放行；某一级放行失败时，更低级也不会越过它占用令牌
+        for (size_t i = 0; i < PRIORITY_COUNT; ++i)
+        {
+            auto& queue = pending_[i];
+            while (!queue.empty() && TryTake(now, static_cast<RequestPriority>(i)))
+            {
+                running_.push_back(queue.front().owner_);
+                ready.push_back(std::move(queue.front()));
+                queue.pop_front();
+            }
+            if (!queue.empty())
+            {
+                break;
+            }
+        }
+        ScheduleDrain();
+    }
+
+    for (auto& pending : ready)
+    {
+        try
+        {
+            pending.task_();
+        }
+        catch (const std::exception& e)
+        {
+            AOIP_LOG_ERROR("Error in paced task: " << e.what());
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_.erase(std::find(running_.begin(), running_.end(), pending.owner_));
+        runningDone_.notify_all();
+    }
+}
+
+void EndpointPacer::ScheduleDrain()
+{
+    if (drainScheduled_ || config_.ratePerSecond_ == 0)
+    {
+        return;
+    }
+
+    // 只看最高优先级的队首；它受窗口限制时由 Release 驱动，无需定时
+    size_t head = 0;
+    while (head < PRIORITY_COUNT && pending_[head].empty())
+    {
+        ++head;
+    }
+    if (head == PRIORITY_COUNT ||
+        (config_.maxInFlight_ != 0 && inFlight_ >= WindowFor(static_cast<RequestPriority>(head))))
+    {
+        return;
+    }
+
+    const double waitMs = std::max(0.0, (1 - tokens_) * 1000 / config_.ratePerSecond_);
+    drainScheduled_ = true;
+    std::weak_ptr<EndpointPacer> weak = weak_from_this();
+    reactor_->RunAfter(static_cast<uint32_t>(std::ceil(waitMs)), [weak]() {
+        auto pacer = weak.lock();
+        if (!pacer)
+        {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(pacer->mutex_);
+            pacer->drainScheduled_ = false;
+        }
+        pacer->Drain();
+    });
+}
+
+}  // namespace aoip
@@ -0,0 +1,307 @@
+#include <pthread.h>
+#include <sched.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <future>
+#include "Reactor.h"
+#include "Logger.h"
+#include "code/ErrorCode.h"
+
+namespace aoip
+{
+
+Reactor::Reactor()
+{
+    epollFd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd_ < 0)
+    {
+        RUNTIME_EXCEPTION("Failed to create epoll: " << strerror(errno));
+    }
+
+    wakeupFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeupFd_ < 0)
+    {
+        close(epollFd_);
+        RUNTIME_EXCEPTION("Failed to create eventfd: " << strerror(errno));
+    }
+
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.fd = wakeupFd_;
+    epoll_ctl(epollFd_, EPOLL_CTL_ADD, wakeupFd_, &event);
+}
+
+Reactor::~Reactor()
+{
+    Stop();
+    close(wakeupFd_);
+    close(epollFd_);
+}
+
+void Reactor::Start()
+{
+    std::lock_guard<std::mutex> lock(taskMutex_);
+    if (running_) return;
+
+    running_ = true;
+    thread_ = std::thread(&Reactor::Loop, this);
+    if (cpu_ >= 0)
+    {
+        ApplyCpuAffinity();
+    }
+}
+
+bool Reactor::SetCpuAffinity(int cpu)
+{
+    std::lock_guard<std::mutex> lock(taskMutex_);
+    cpu_ = cpu;
+    return cpu_ < 0 || !running_ || ApplyCpuAffinity();
+}
+
+bool Reactor::ApplyCpuAffinity()
+{
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(cpu_, &cpus);
+    const int ret = pthread_setaffinity_np(thread_.native_handle(), sizeof(cpus), &cpus);
+    if (ret != 0)
+    {
+        AOIP_LOG_WARN("Failed to set cpu affinity, cpu=" << cpu_ << ", error=" << strerror(ret));
+        return false;
+    }
+    return true;
+}
+
+void Reactor::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(taskMutex_);
+        if (!running_) return;
+        running_ = false;
+    }
+
+    Wakeup();
+    if (thread_.joinable())
+    {
+        thread_.join();
+    }
+    // 循环退出前投递的任务在这里补执行
+    RunPendingTasks();
+}
+
+bool Reactor::AddHandler(int fd, EventHandler handler)
+{
+    {
+        std::lock_guard<std::mutex> lock(handlerMutex_);
+        handlers_[fd] = std::make_shared<EventHandler>(std::move(handler));
+    }
+
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    if (epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &event) < 0)
+    {
+        AOIP_LOG_ERROR("Failed to add fd to epoll, fd=" << fd << ", error=" << strerror(errno));
+        std::lock_guard<std::mutex> lock(handlerMutex_);
+        handlers_.erase(fd);
+        return false;
+    }
+    return true;
+}
+
+void Reactor::RemoveHandler(int fd)
+{
+    epoll_ctl(epollFd_, EPOLL_CTL_DEL, fd, nullptr);
+    {
+        std::lock_guard<std::mutex> lock(handlerMutex_);
+        handlers_.erase(fd);
+    }
+    Sync();
+}
+
+uint64_t Reactor::RunAfter(uint32_t delayMs, Task task)
+{
+    const auto now = TimerWheel::Clock::now();
+    const auto deadline = now + std::chrono::milliseconds(delayMs);
+    bool needWakeup = false;
+    uint64_t timerId = 0;
+    {
+        std::lock_guard<std::mutex> lock(timerMutex_);
+        timerId = timerWheel_.Schedule(now, delayMs, std::move(task));
+        // 只有比事件循环当前等待时间更早的定时器才需要唤醒
+        if (deadline < nextWakeup_)
+        {
+            nextWakeup_ = deadline;
+            needWakeup = true;
+        }
+    }
+
+    if (needWakeup && !IsInLoopThread())
+    {
+        Wakeup();
+    }
+    return timerId;
+}
+
+bool Reactor::CancelTimer(uint64_t timerId)
+{
+    std::lock_guard<std::mutex> lock(timerMutex_);
+    return timerWheel_.Cancel(timerId);
+}
+
+void Reactor::Post(Task task)
+{
+    {
+        std::lock_guard<std::mutex> lock(taskMutex_);
+        if (running_)
+        {
+            pendingTasks_.push_back(std::move(task));
+            task = nullptr;
+        }
+    }
+
+    if (task)
+    {
+        task();
+    }
+    else
+    {
+        Wakeup();
+    }
+}
+
+void Reactor::Sync()
+{
+    if (!running_ || IsInLoopThread())
+    {
+        return;
+    }
+
+    std::promise<void> done;
+    auto future = done.get_future();
+    Post([&done]() { done.set_value(); });
+    future.wait();
+}
+
+void Reactor::Wakeup()
+{
+    uint64_t one = 1;
+    ssize_t ret = write(wakeupFd_, &one, sizeof(one));
+    (void)ret;
+}
+
+void Reactor::DrainWakeup()
+{
+    uint64_t value = 0;
+    ssize_t ret = read(wakeupFd_, &value, sizeof(value));
+    (void)ret;
+}
+
+int Reactor::PrepareWait()
+{
+    const auto now = TimerWheel::Clock::now();
+    std::lock_guard<std::mutex> lock(timerMutex_);
+    const int timeoutMs = timerWheel_.NextTimeoutMs(now);
+    nextWakeup_ = timeoutMs < 0 ? TimerWheel::Clock::time_point::max() : now + std::chrono::milliseconds(timeoutMs);
+    return timeoutMs;
+}
+
+void Reactor::Loop()
+{
+    loopThreadId_.store(std::this_thread::get_id());
+    struct epoll_event events[MAX_EVENTS];
+
+    while (running_)
+    {
+        const int count = epoll_wait(epollFd_, events, MAX_EVENTS, PrepareWait());
+        if (count < 0 && errno != EINTR)
+        {
+            AOIP_LOG_ERROR("epoll_wait failed: " << strerror(errno));
+        }
+
+        for (int i = 0; i < count; ++i)
+        {
+            const int fd = events[i].data.fd;
+            if (fd == wakeupFd_)
+            {
+                DrainWakeup();
+                continue;
+            }
+
+            std::shared_ptr<EventHandler> handler;
+            {
+                std::lock_guard<std::mutex> lock(handlerMutex_);
+                auto it = handlers_.find(fd);
+                if (it != handlers_.end())
+                {
+                    handler = it->second;
+                }
+            }
+
+            try
+            {
+                if (handler)
+                {
+                    (*handler)();
+                }
+            }
+            catch (const std::exception& e)
+            {
+                AOIP_LOG_ERROR("Error in event handler: " << e.what());
+            }
+        }
+
+        RunExpiredTimers();
+        RunPendingTasks();
+    }
+    loopThreadId_.store(std::thread::id());
+}
+
+void Reactor::RunExpiredTimers()
+{
+    std::vector<TimerWheel::TimerCallback> expired;
+    {
+        std::lock_guard<std::mutex> lock(timerMutex_);
+        timerWheel_.Advance(TimerWheel::Clock::now(), expired);
+    }
+
+    for (auto& callback : expired)
+    {
+        try
+        {
+            callback();
+        }
+        catch (const std::exception& e)
+        {
+            AOIP_LOG_ERROR("Error in timer callback: " << e.what());
+        }
+    }
+}
+
+void Reactor::RunPendingTasks()
+{
+    std::vector<Task> tasks;
+    {
+        std::lock_guard<std::mutex> lock(taskMutex_);
+        tasks.swap(pendingTasks_);
+    }
+
+    for (auto& task : tasks)
+    {
+        try
+        {
+            task();
+        }
+        catch (const std::exception& e)
+        {
+            AOIP_LOG_ERROR("Error in posted task: " << e.what());
+        }
+    }
+}
+
+}  // namespace aoip
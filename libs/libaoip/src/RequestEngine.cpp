@@ -0,0 +1,543 @@
+#include <algorithm>
+#include <cstring>
+#include "RequestEngine.h"
+#include "Logger.h"
+#include "code/ErrorCode.h"
+
+namespace aoip
+{
+
+namespace
+{
+// FNV-1a，请求报文很短，足以区分同一功能号下的不同参数
+uint64_t HashBody(const void* data, size_t len)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < len; ++i)
+    {
+        hash = (hash ^ bytes[i]) * 0x100000001b3ULL;
+    }
+    return hash;
+}
+}  // namespace
+
+void Request::SetPayload(const void* data, size_t len)
+{
+    payload_ = BufferPool::Instance().Acquire(len);
+    memcpy(payload_.MutableData(), data, len);
+    bodyHash_ = HashBody(data, len);
+    bodyLen_ = len;
+}
+
+void Request::Complete(const FrameBuffer& response)
+{
+    for (auto& follower : followers_)
+    {
+        follower->Complete(response);
+    }
+
+    if (!handler_)
+    {
+        promise_.set_value(response);
+        return;
+    }
+
+    try
+    {
+        handler_(response, nullptr);
+    }
+    catch (const std::exception& e)
+    {
+        AOIP_LOG_ERROR("Error in response handler: " << e.what());
+    }
+}
+
+void Request::Fail(std::exception_ptr error)
+{
+    for (auto& follower : followers_)
+    {
+        follower->Fail(error);
+    }
+
+    if (!handler_)
+    {
+        promise_.set_exception(error);
+        return;
+    }
+
+    try
+    {
+        handler_(FrameBuffer(), error);
+    }
+    catch (const std::exception& e)
+    {
+        AOIP_LOG_ERROR("Error in response handler: " << e.what());
+    }
+}
+
+RequestManager::RequestManager(std::shared_ptr<Reactor> reactor, const RequestConfig& config, Transmitter transmitter,
+                               std::shared_ptr<EndpointPacer> pacer)
+    : reactor_(reactor),
+      transmitter_(std::move(transmitter)),
+      pacer_(pacer),
+      maxRetries_(config.maxRetries_),
+      rttEstimator_(config.timeoutMs_, config.minTimeoutMs_, config.timeoutMs_),
+      random_(std::random_device()())
+{
+}
+
+uint32_t RequestManager::ShardIndex(const Request& request) const
+{
+    return request.keyed_ ? static_cast<uint32_t>(RequestKeyHash()(request.key_) & (SHARD_COUNT - 1)) : 0;
+}
+
+uint32_t RequestManager::GetTimeoutMs(const Request& request)
+{
+    std::lock_guard<std::mutex> lock(rttMutex_);
+    return std::min(rttEstimator_.GetTimeoutMs(), request.timeoutMs_);
+}
+
+RequestManager::AddResult RequestManager::AddRequest(std::shared_ptr<Request> request)
+{
+    const uint32_t shardIndex = ShardIndex(*request);
+    Shard& shard = shards_[shardIndex];
+    std::lock_guard<std::mutex> lock(shard.mutex_);
+    // Stop 清除标志后才锁分片：这里看到仍在运行时，登记的请求一定会被 Stop 取出并结束
+    if (!accepting_)
+    {
+        return AddResult::STOPPED;
+    }
+    const uint32_t requestId = (nextRequestId_.fetch_add(1, std::memory_order_relaxed) << SHARD_BITS) | shardIndex;
+    if (request->keyed_)
+    {
+        auto result = shard.keyedRequests_.emplace(request->key_, requestId);
+        if (!result.second)
+        {
+            // 同一设备的相同查询只发送一次，其余调用方等待同一个响应
+            auto it = shard.requests_.find(result.first->second);
+            if (it != shard.requests_.end() && it->second->bodyHash_ == request->bodyHash_ &&
+                it->second->bodyLen_ == request->bodyLen_)
+            {
+                it->second->followers_.push_back(request);
+                return AddResult::COALESCED;
+            }
+            return AddResult::REJECTED;
+        }
+    }
+    shard.requests_[requestId] = request;
+
+    // 窗口或令牌不足时排队，超时从实际发送时开始计算
+    if (pacer_ && !pacer_->Admit(this, request->priority_, [this, requestId]() { SendQueued(requestId); }))
+    {
+        return AddResult::QUEUED;
+    }
+
+    // 在锁内挂载定时器，保证匹配或超时时 timerId_ 已就绪
+    request->admitted_ = true;
+    request->attempts_ = 1;
+    request->timestamp_ = std::chrono::steady_clock::now();
+    ArmTimer(request, requestId, GetTimeoutMs(*request));
+    return AddResult::SEND;
+}
+
+void RequestManager::SendQueued(uint32_t requestId)
+{
+    FrameBuffer payload;
+    {
+        Shard& shard = ShardOf(requestId);
+        std::lock_guard<std::mutex> lock(shard.mutex_);
+        auto it = shard.requests_.find(requestId);
+        if (it != shard.requests_.end())
+        {
+            auto& request = it->second;
+            request->admitted_ = true;
+            request->attempts_ = 1;
+            request->timestamp_ = std::chrono::steady_clock::now();
+            ArmTimer(request, requestId, GetTimeoutMs(*request));
+            payload = request->payload_;
+        }
+    }
+
+    if (payload.empty())
+    {
+        // 排队期间已被取消，归还放行时占用的窗口
+        if (pacer_)
+        {
+            pacer_->Release();
+        }
+        return;
+    }
+    transmitter_(payload);
+}
+
+void RequestManager::ReleaseWindow(const std::shared_ptr<Request>& request)
+{
+    if (pacer_ && request->admitted_)
+    {
+        pacer_->Release();
+    }
+}
+
+void RequestManager::ArmTimer(const std::shared_ptr<Request>& request, uint32_t requestId, uint32_t timeoutMs)
+{
+    request->timerId_ = reactor_->RunAfter(timeoutMs, [this, requestId]() { ExpireRequest(requestId); });
+}
+
+uint32_t RequestManager::Jitter(uint32_t timeoutMs)
+{
+    std::uniform_real_distribution<double> dist(1 - RETRY_JITTER, 1 + RETRY_JITTER);
+    return std::max<uint32_t>(1, static_cast<uint32_t>(timeoutMs * dist(random_)));
+}
+
+bool RequestManager::MatchResponse(const FrameBuffer& response, uint32_t fromIp, uint16_t fromPort)
+{
+    auto udpCallback = udpCallback_.lock();
+    if (!udpCallback)
+    {
+        AOIP_LOG_ERROR("udp callback is null!");
+        return false;
+    }
+
+    // 优先按 (端点, 功能号, 序列号) 哈希关联，解析在锁外完成
+    std::shared_ptr<Request> request;
+    RequestKey key;
+    key.ip_ = fromIp;
+    key.port_ = fromPort;
+    if (udpCallback->GetCorrelationKey(response, key.functionCode_, key.sequence_))
+    {
+        request = TakeKeyedRequest(key);
+        if (!request)
+        {
+            // 已解析出功能号，不必再次解析
+            request = TakeFunctionCodeRequest(key.functionCode_);
+        }
+    }
+    else if (udpCallback->GetFunctionCode(response, key.functionCode_))
+    {
+        request = TakeFunctionCodeRequest(key.functionCode_);
+    }
+    if (!request)
+    {
+        return false;
+    }
+
+    // 完成请求会唤醒调用方，调用方可能随即释放回调的所有者（连同本引擎和通道），
+    // 因此先释放回调的引用，避免最后一个引用在收包线程上释放
+    udpCallback.reset();
+    CompleteRequest(request, response);
+    return true;
+}
+
+std::shared_ptr<Request> RequestManager::TakeKeyedRequest(const RequestKey& key)
+{
+    Shard& shard = shards_[RequestKeyHash()(key) & (SHARD_COUNT - 1)];
+    std::lock_guard<std::mutex> lock(shard.mutex_);
+    auto keyIt = shard.keyedRequests_.find(key);
+    if (keyIt == shard.keyedRequests_.end())
+    {
+        return nullptr;
+    }
+
+    auto it = shard.requests_.find(keyIt->second);
+    if (it == shard.requests_.end())
+    {
+        shard.keyedRequests_.erase(keyIt);
+        return nullptr;
+    }
+    return TakeRequest(shard, it);
+}
+
+std::shared_ptr<Request> RequestManager::TakeFunctionCodeRequest(uint16_t functionCode)
+{
+    Shard& shard = shards_[0];
+    std::lock_guard<std::mutex> lock(shard.mutex_);
+    for (auto it = shard.requests_.begin(); it != shard.requests_.end(); ++it)
+    {
+        if (!it->second->keyed_ && it->second->functionCode_ == functionCode)
+        {
+            return TakeRequest(shard, it);
+        }
+    }
+    return nullptr;
+}
+
+std::shared_ptr<Request> RequestManager::EraseRequest(Shard& shard, RequestMap::iterator it)
+{
+    auto request = it->second;
+    if (request->keyed_)
+    {
+        shard.keyedRequests_.erase(request->key_);
+    }
+    shard.requests_.erase(it);
+    return request;
+}
+
+void RequestManager::CompleteRequest(const std::shared_ptr<Request>& request, const FrameBuffer& response)
+{
+    reactor_->CancelTimer(request->timerId_);
+    ReleaseWindow(request);
+    request->Complete(response);
+}
+
+std::shared_ptr<Request> RequestManager::TakeRequest(Shard& shard, RequestMap::iterator it)
+{
+    // Karn 算法：重传过的请求无法确定响应对应哪次发送，不作为 RTT 样本
+    if (it->second->attempts_ == 1)
+    {
+        const auto rtt = std::chrono::steady_clock::now() - it->second->timestamp_;
+        std::lock_guard<std::mutex> lock(rttMutex_);
+        rttEstimator_.OnSample(std::chrono::duration<double, std::milli>(rtt).count());
+    }
+    return EraseRequest(shard, it);
+}
+
+void RequestManager::ExpireRequest(uint32_t requestId)
+{
+    std::shared_ptr<Request> request;
+    FrameBuffer payload;
+    {
+        Shard& shard = ShardOf(requestId);
+        std::lock_guard<std::mutex> lock(shard.mutex_);
+        auto it = shard.requests_.find(requestId);
+        if (it == shard.requests_.end())
+        {
+            return;
+        }
+
+        std::lock_guard<std::mutex> rttLock(rttMutex_);
+        rttEstimator_.OnTimeout();
+        if (!it->second->payload_.empty() && it->second->attempts_ <= maxRetries_)
+        {
+            // 退避后的 RTO 再加抖动，繁忙设备不会被过早的重传压垮
+            ++it->second->attempts_;
+            payload = it->second->payload_;
+            ArmTimer(it->second, requestId, Jitter(std::min(rttEstimator_.GetTimeoutMs(), it->second->timeoutMs_)));
+        }
+        else
+        {
+            request = EraseRequest(shard, it);
+        }
+    }
+
+    if (!payload.empty())
+    {
+        AOIP_LOG_DEBUG("Retransmit request, requestId=" << requestId);
+        transmitter_(payload);
+        return;
+    }
+    ReleaseWindow(request);
+    request->Fail(std::make_exception_ptr(std::runtime_error("Request timeout")));
+}
+
+void RequestManager::Start()
+{
+    accepting_ = true;
+}
+
+void RequestManager::Stop(const std::string& reason)
+{
+    accepting_ = false;
+    RequestMap requests;
+    for (auto& shard : shards_)
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex_);
+        requests.insert(shard.requests_.begin(), shard.requests_.end());
+        shard.requests_.clear();
+        shard.keyedRequests_.clear();
+    }
+    if (pacer_)
+    {
+        pacer_->Cancel(this);
+    }
+
+    for (auto& item : requests)
+    {
+        reactor_->CancelTimer(item.second->timerId_);
+        ReleaseWindow(item.second);
+        item.second->Fail(std::make_exception_ptr(std::runtime_error(reason)));
+    }
+}
+
+void RequestManager::SetUdpCallback(std::shared_ptr<UdpCallback> cb)
+{
+    udpCallback_ = cb;
+}
+
+RequestEngine::RequestEngine(std::shared_ptr<Reactor> reactor, const RequestConfig& config, Transport& transport,
+                             const Endpoint& peer, std::shared_ptr<EndpointPacer> pacer)
+    : config_(config),
+      reactor_(reactor),
+      transport_(transport),
+      peer_(peer),
+      pacer_(pacer),
+      requestManager_(reactor, config, [this](const FrameBuffer& payload) { transport_.Transmit(payload); }, pacer),
+      subscriptions_(std::make_shared<const SubscriptionList>())
+{
+}
+
+void RequestEngine::Start()
+{
+    requestManager_.Start();
+    running_ = true;
+}
+
+void RequestEngine::Stop(const std::string& reason)
+{
+    running_ = false;
+    requestManager_.Stop(reason);
+    // 等待可能正在执行的超时回调结束
+    reactor_->Sync();
+}
+
+std::future<FrameBuffer> RequestEngine::SendRequest(uint16_t functionCode, const void* data, size_t len)
+{
+    auto request = std::make_shared<Request>(functionCode, config_.timeoutMs_);
+    auto future = request->promise_.get_future();
+    Send(request, data, len);
+    return future;
+}
+
+std::future<FrameBuffer> RequestEngine::SendRequest(uint16_t functionCode, uint32_t sequence, const void* data, size_t len,
+                                                    RequestPriority priority)
+{
+    auto request = MakeRequest(functionCode, sequence, priority);
+    auto future = request->promise_.get_future();
+    Send(request, data, len);
+    return future;
+}
+
+void RequestEngine::SendRequest(uint16_t functionCode, uint32_t sequence, const void* data, size_t len, ResponseHandler handler,
+                                RequestPriority priority)
+{
+    auto request = MakeRequest(functionCode, sequence, priority);
+    request->handler_ = std::move(handler);
+    Send(request, data, len);
+}
+
+std::shared_ptr<Request> RequestEngine::MakeRequest(uint16_t functionCode, uint32_t sequence, RequestPriority priority) const
+{
+    RequestKey key;
+    // 响应来源不确定时端点置 0 匹配任意来源
+    if (peer_.IsValid())
+    {
+        key.ip_ = peer_.ip_;
+        key.port_ = peer_.port_;
+    }
+    key.functionCode_ = functionCode;
+    key.sequence_ = sequence;
+    auto request = std::make_shared<Request>(key, config_.timeoutMs_);
+    request->priority_ = priority;
+    return request;
+}
+
+void RequestEngine::Send(const std::shared_ptr<Request>& request, const void* data, size_t len)
+{
+    if (!running_)
+    {
+        RUNTIME_EXCEPTION("Protocol not started");
+    }
+    if (Register(request, data, len))
+    {
+        transport_.Transmit(request->payload_);
+    }
+}
+
+bool RequestEngine::Register(const std::shared_ptr<Request>& request, const void* data, size_t len)
+{
+    // 批量发送时不能抛出，否则之前已登记的请求不会被发送
+    if (!running_)
+    {
+        request->Fail(std::make_exception_ptr(std::runtime_error("Protocol not started")));
+        return false;
+    }
+
+    request->SetPayload(data, len);
+    switch (requestManager_.AddRequest(request))
+    {
+        case RequestManager::AddResult::SEND:
+            return true;
+        case RequestManager::AddResult::QUEUED:
+            AOIP_LOG_DEBUG("Request throttled, functionCode=" << request->key_.functionCode_ << ", sequence=" << request->key_.sequence_);
+            return false;
+        case RequestManager::AddResult::REJECTED:
+            AOIP_LOG_WARN("Conflicting in-flight request, functionCode=" << request->key_.functionCode_ << ", sequence=" << request->key_.sequence_);
+            request->Fail(std::make_exception_ptr(std::runtime_error("Duplicate in-flight request")));
+            return false;
+        case RequestManager::AddResult::STOPPED:
+            // 与 Stop 并发时，前面的 running_ 检查可能已经通过
+            request->Fail(std::make_exception_ptr(std::runtime_error("Protocol not started")));
+            return false;
+        case RequestManager::AddResult::COALESCED:
+        default:
+            AOIP_LOG_DEBUG("Coalesced request, functionCode=" << request->key_.functionCode_ << ", sequence=" << request->key_.sequence_);
+            return false;
+    }
+}
+
+bool RequestEngine::OnReceive(const FrameBuffer& frame, uint32_t fromIp, uint16_t fromPort)
+{
+    const bool matched = peer_.IsValid() ? requestManager_.MatchResponse(frame, fromIp, fromPort)
+                                         : requestManager_.MatchResponse(frame);
+    // 未匹配在途请求的帧视为设备主动上报
+    return matched || DispatchEvent(frame, fromIp, fromPort);
+}
+
+void RequestEngine::SetCorrelationCallback(std::shared_ptr<UdpCallback> cb)
+{
+    udpCallback_ = cb;
+    requestManager_.SetUdpCallback(cb);
+}
+
+std::shared_ptr<EventSubscription> RequestEngine::Subscribe(uint32_t functionCode, uint64_t sequence, size_t capacity,
+                                                            EventSubscription::Notifier notifier)
+{
+    auto subscription = std::make_shared<EventSubscription>(functionCode, sequence, capacity, std::move(notifier));
+    std::lock_guard<std::mutex> lock(subscriptionMutex_);
+    auto list = std::make_shared<SubscriptionList>(*subscriptions_);
+    list->push_back(subscription);
+    std::atomic_store(&subscriptions_, std::shared_ptr<const SubscriptionList>(list));
+    return subscription;
+}
+
+void RequestEngine::Unsubscribe(const std::shared_ptr<EventSubscription>& subscription)
+{
+    {
+        std::lock_guard<std::mutex> lock(subscriptionMutex_);
+        auto list = std::make_shared<SubscriptionList>(*subscriptions_);
+        list->erase(std::remove(list->begin(), list->end(), subscription), list->end());
+        std::atomic_store(&subscriptions_, std::shared_ptr<const SubscriptionList>(list));
+    }
+    // 等待收包线程上持有旧快照的分发结束
+    transport_.Sync();
+}
+
+bool RequestEngine::DispatchEvent(const FrameBuffer& frame, uint32_t fromIp, uint16_t fromPort)
+{
+    // 每个未匹配的帧都会读取快照，读取不加锁
+    const auto subscriptions = std::atomic_load(&subscriptions_);
+    if (subscriptions->empty())
+    {
+        return false;
+    }
+
+    EventFrame event;
+    event.frame_ = frame;
+    event.fromIp_ = fromIp;
+    event.fromPort_ = fromPort;
+    auto udpCallback = udpCallback_.lock();
+    const bool parsed = udpCallback && udpCallback->GetCorrelationKey(frame, event.functionCode_, event.sequence_);
+    udpCallback.reset();
+
+    bool delivered = false;
+    for (const auto& subscription : *subscriptions)
+    {
+        if (subscription->Matches(parsed, event.functionCode_, event.sequence_))
+        {
+            delivered = subscription->Publish(event) || delivered;
+        }
+    }
+    return delivered;
+}
+
+}  // namespace aoip
@@ -0,0 +1,51 @@
+#include <algorithm>
+#include <cmath>
+#include "RttEstimator.h"
+
+namespace aoip
+{
+
+namespace
+{
+constexpr double RTT_ALPHA = 1.0 / 8;
+constexpr double RTT_BETA = 1.0 / 4;
+constexpr double RTT_K = 4;
+constexpr double CLOCK_GRANULARITY_MS = 1;  // 时间轮刻度
+}  // namespace
+
+RttEstimator::RttEstimator(uint32_t initialTimeoutMs, uint32_t minTimeoutMs, uint32_t maxTimeoutMs)
+    : minTimeoutMs_(minTimeoutMs),
+      maxTimeoutMs_(std::max(minTimeoutMs, maxTimeoutMs)),
+      rtoMs_(initialTimeoutMs)
+{
+}
+
+void RttEstimator::OnSample(double rttMs)
+{
+    if (!hasSample_)
+    {
+        srttMs_ = rttMs;
+        rttVarMs_ = rttMs / 2;
+        hasSample_ = true;
+    }
+    else
+    {
+        rttVarMs_ = (1 - RTT_BETA) * rttVarMs_ + RTT_BETA * std::fabs(srttMs_ - rttMs);
+        srttMs_ = (1 - RTT_ALPHA) * srttMs_ + RTT_ALPHA * rttMs;
+    }
+    rtoMs_ = srttMs_ + std::max(CLOCK_GRANULARITY_MS, RTT_K * rttVarMs_);
+    backoff_ = 1;
+}
+
+void RttEstimator::OnTimeout()
+{
+    backoff_ = std::min(backoff_ * 2, MAX_BACKOFF);
+}
+
+uint32_t RttEstimator::GetTimeoutMs() const
+{
+    const double timeoutMs = std::ceil(rtoMs_ * backoff_);
+    return static_cast<uint32_t>(std::clamp(timeoutMs, static_cast<double>(minTimeoutMs_), static_cast<double>(maxTimeoutMs_)));
+}
+
+}  // namespace aoip
@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <cstring>
 #include <functional>
 #include "SerialProtocol.h"
 #include "common/LoggerWrapper.h"
@@ -6,17 +8,22 @@ namespace aoip
 {
 DEFINE_FILE_NAME("SerialTask.cpp")
 
-SerialTask::SerialTask(std::shared_ptr<ResponseCallback> cb, const std::string& port, uint32_t baudRate, uint32_t readTimeoutSecond)
+SerialTask::SerialTask(std::shared_ptr<ResponseCallback> cb, const std::string& port, uint32_t baudRate, uint32_t readTimeoutSecond,
+                       const RequestConfig& config)
     : cb_(cb)
     , running_(false)
     , readingInProgress_(false)
-    , writingInProgress_(false)
     , io_()
     , serial_(io_, port)
     , timeoutTimer_(io_)
     , readTimeoutSecond_(readTimeoutSecond)
     , logger_(Poco::Logger::get("SerialTask"))
 {
+    // 串口只有一个对端，关联键不含端点
+    auto reactor = TransportRuntime::Instance().NextReactor();
+    auto pacer = config.pacer_.Unlimited() ? nullptr : std::make_shared<EndpointPacer>(config.pacer_, reactor);
+    engine_ = std::make_unique<RequestEngine>(reactor, config, static_cast<Transport&>(*this), Endpoint(), pacer);
+
     serial_.set_option(boost::asio::serial_port_base::baud_rate(baudRate));
     serial_.set_option(boost::asio::serial_port_base::character_size(8));
     serial_.set_option(boost::asio::serial_port_base::parity(boost::asio::serial_port_base::parity::none));
@@ -35,6 +42,10 @@ void SerialTask::Start()
     if (!running_.load())
     {
         running_.store(true);
+        // 上次 Stop 后 io_ 处于停止状态，需要重置；work guard 保证没有读写时 run 也不返回
+        io_.restart();
+        work_.reset(new WorkGuard(io_.get_executor()));
+        engine_->Start();
         thread_.start(*this);
     }
 }
@@ -43,33 +54,41 @@ void SerialTask::Stop()
 {
     if (running_.load())
     {
-        running_.store(false);
+        {
+            std::lock_guard<std::mutex> lock(syncMutex_);
+            running_.store(false);
+        }
+        // 先停止引擎：结束在途请求并等待超时回调执行完，之后不会再有重传写入队列
+        engine_->Stop("Serial task stopped");
+        // 在 io_ 线程取消读写和定时器，已取消的回调执行完后 run 自然返回
+        boost::asio::post(io_, [this]() {
+            boost::system::error_code ec;
+            serial_.cancel(ec);
+            timeoutTimer_.cancel();
+        });
+        work_.reset();
         thread_.join();
+
+        {
+            std::lock_guard<std::mutex> lock(writeMutex_);
+            writeQueue_.clear();
+            pendingWriteBytes_ = 0;
+            writingInProgress_ = false;
+        }
+        framer_.Reset();
     }
 }
 
-
 void SerialTask::run()
 {
     try
     {
-        while (running_.load())
+        if (serial_.is_open())
         {
-
-            if (serial_.is_open() && !readingInProgress_)
-            {
-                std::vector<uint8_t> buffer(4096);
-                readingInProgress_ = true;
-                boost::asio::async_read(serial_, boost::asio::buffer(buffer),
-                    std::bind(&SerialTask::handleRead, this, boost::asio::placeholders::error, boost::asio::placeholders::bytes_transferred, buffer));
-                // 启动超时定时器
-                timeoutTimer_.expires_after(boost::asio::chrono::seconds(readTimeoutSecond_));
-                timeoutTimer_.async_wait(std::bind(&SerialTask::handleTimeout, this, boost::asio::placeholders::error));
-                io_.run_one();
-                LOG_INFO_THIS("serial task read finished!");
-            }
-            Poco::Thread::sleep(1);
+            StartRead();
         }
+        ArmIdleTimer();
+        io_.run();
     }
     catch (std::exception& e)
     {
@@ -77,45 +96,208 @@ void SerialTask::run()
     }
 }
 
-void SerialTask::handleRead(const boost::system::error_code& ec, std::size_t bytesRead, std::vector<uint8_t>& buffer)
+void SerialTask::StartRead()
+{
+    readingInProgress_ = true;
+    serial_.async_read_some(boost::asio::buffer(framer_.WritePtr(), framer_.Writable()),
+        [this](const boost::system::error_code& ec, std::size_t bytesRead) { handleRead(ec, bytesRead); });
+}
+
+void SerialTask::handleRead(const boost::system::error_code& ec, std::size_t bytesRead)
 {
     readingInProgress_ = false;
-    writingInProgress_ = false;
-    if (!ec && cb_.lock())
+    if (ec)
     {
-        buffer.resize(bytesRead);
-        cb_.lock()->OnRecvResponse(buffer);
+        if (boost::asio::error::operation_aborted != ec)
+        {
+            // 读错误（如设备拔出）时不立即重试，由空闲定时器稍后重新发起读取
+            LOG_ERROR_THIS("Read error: " << ec.message());
+        }
+        return;
+    }
+
+    lastReadTime_ = std::chrono::steady_clock::now();
+    const auto discarded = framer_.GetDiscarded();
+    framer_.Commit(bytesRead, [this](const FrameBuffer& frame) {
+        // 只用 Write 的调用方不设置关联回调，帧直接交给 ResponseCallback
+        if (correlated_ && engine_->OnReceive(frame))
+        {
+            return;
+        }
+        if (auto cb = cb_.lock())
+        {
+            cb->OnRecvResponse(frame);
+        }
+    });
+    if (framer_.GetDiscarded() != discarded)
+    {
+        LOG_WARNING_THIS("discard " << framer_.GetDiscarded() - discarded << " bytes to resync frame header");
     }
-    else
+
+    if (running_)
     {
-        LOG_ERROR_THIS("Read error: " << ec.message());
+        StartRead();
     }
-    timeoutTimer_.cancel();
+}
 
+void SerialTask::ArmIdleTimer()
+{
+    // 不随每次读取重置，到期时按最后一次读到数据的时间判断是否空闲
+    timeoutTimer_.expires_after(std::chrono::seconds(readTimeoutSecond_));
+    timeoutTimer_.async_wait(std::bind(&SerialTask::handleTimeout, this, std::placeholders::_1));
 }
 
 void SerialTask::handleTimeout(const boost::system::error_code& ec)
 {
-    if (!ec)
+    if (ec || !running_)
+    {
+        return;
+    }
+
+    if (std::chrono::steady_clock::now() - lastReadTime_ >= std::chrono::seconds(readTimeoutSecond_) &&
+        framer_.GetPending() > 0)
     {
-        LOG_ERROR_THIS("Read timeout");
-        // 取消正在进行的异步读取操作
-        timeoutTimer_.cancel();
-        readingInProgress_ = false;
-        writingInProgress_ = false;
-        // TO DO 超时处理
+        // 读取仍在进行，只丢弃残留的半帧
+        LOG_ERROR_THIS("Read timeout, drop " << framer_.GetPending() << " pending bytes");
+        framer_.Reset();
     }
+    if (!readingInProgress_ && serial_.is_open())
+    {
+        StartRead();
+    }
+    ArmIdleTimer();
 }
 
-void SerialTask::Write(const void* data, uint32_t size)
+bool SerialTask::Write(const void* data, uint32_t size)
 {
-    LOG_INFO_THIS("serial task write is open=" << serial_.is_open() << ", writingInProgress=" << writingInProgress_);
-    // 收到请求响应或者响应超时后 才能继续发送请求
-    if (serial_.is_open() && !writingInProgress_)
+    FrameBuffer frame = BufferPool::Instance().Acquire(size);
+    memcpy(frame.MutableData(), data, size);
+    return Enqueue(frame);
+}
+
+bool SerialTask::Enqueue(const FrameBuffer& frame)
+{
+    // 停止后不再入队，否则投递的写任务会留在 io_ 中，到下次 Start 才执行
+    if (!running_)
     {
+        return false;
+    }
+    if (!serial_.is_open())
+    {
+        LOG_ERROR_THIS("serial port is not open");
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        if (pendingWriteBytes_ + frame.size() > MAX_PENDING_WRITE_BYTES)
+        {
+            LOG_WARNING_THIS("serial write queue full, pending=" << pendingWriteBytes_ << ", drop " << frame.size() << " bytes");
+            return false;
+        }
+        writeQueue_.push_back(frame);
+        pendingWriteBytes_ += frame.size();
+        if (writingInProgress_)
+        {
+            // 由正在进行的写任务完成后接着发送
+            return true;
+        }
         writingInProgress_ = true;
-        boost::asio::write(serial_, boost::asio::buffer(data, size));
     }
+    boost::asio::post(io_, [this]() { StartWrite(); });
+    return true;
+}
+
+void SerialTask::StartWrite()
+{
+    if (!running_)
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        while (!writeQueue_.empty())
+        {
+            sending_.push_back(std::move(writeQueue_.front()));
+            writeQueue_.pop_front();
+        }
+    }
+
+    std::vector<boost::asio::const_buffer> buffers;
+    buffers.reserve(sending_.size());
+    for (const auto& frame : sending_)
+    {
+        buffers.emplace_back(frame.data(), frame.size());
+    }
+    boost::asio::async_write(serial_, buffers,
+        [this](const boost::system::error_code& ec, std::size_t) { handleWrite(ec); });
+}
+
+void SerialTask::handleWrite(const boost::system::error_code& ec)
+{
+    if (ec)
+    {
+        // 未发出的请求由超时重传补发
+        LOG_ERROR_THIS("Write error: " << ec.message());
+    }
+
+    size_t sent = 0;
+    for (const auto& frame : sending_)
+    {
+        sent += frame.size();
+    }
+    sending_.clear();
+    {
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        pendingWriteBytes_ -= std::min(sent, pendingWriteBytes_);
+        if (writeQueue_.empty() || !running_)
+        {
+            writingInProgress_ = false;
+            return;
+        }
+    }
+    StartWrite();
+}
+
+std::future<FrameBuffer> SerialTask::SendRequest(uint16_t functionCode, uint32_t sequence, const void* data, size_t len,
+                                                 RequestPriority priority)
+{
+    return engine_->SendRequest(functionCode, sequence, data, len, priority);
+}
+
+void SerialTask::SendRequest(uint16_t functionCode, uint32_t sequence, const void* data, size_t len, ResponseHandler handler,
+                             RequestPriority priority)
+{
+    engine_->SendRequest(functionCode, sequence, data, len, std::move(handler), priority);
+}
+
+void SerialTask::SetCorrelationCallback(std::shared_ptr<UdpCallback> cb)
+{
+    engine_->SetCorrelationCallback(cb);
+    correlated_ = nullptr != cb;
+}
+
+void SerialTask::Sync()
+{
+    if (io_.get_executor().running_in_this_thread())
+    {
+        return;
+    }
+
+    std::promise<void> done;
+    auto future = done.get_future();
+    {
+        // 已停止时 io_ 可能已经退出，投递的任务不会再执行
+        std::lock_guard<std::mutex> lock(syncMutex_);
+        if (!running_)
+        {
+            return;
+        }
+        // 在 Stop 释放 work guard 之前投递，run 会先执行完它才返回
+        boost::asio::post(io_, [&done]() { done.set_value(); });
+    }
+    future.wait();
 }
 
 }
@@ -0,0 +1,134 @@
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include "StreamFramer.h"
+#include "code/ErrorCode.h"
+
+namespace aoip
+{
+
+StreamFramer::StreamFramer(const FramerConfig& config)
+    : config_(config),
+      capacity_(config.maxFrameSize_ * 2)
+{
+    if (config_.headerSize_ < sizeof(uint32_t) || 0 == config_.lengthUnit_ ||
+        config_.maxFrameSize_ < config_.headerSize_ + sizeof(uint32_t) + config_.trailerSize_)
+    {
+        RUNTIME_EXCEPTION("Invalid framer config, header=" << config_.headerSize_
+                                                           << ", max frame=" << config_.maxFrameSize_);
+    }
+    for (size_t i = 0; i < sizeof(magicBytes_); ++i)
+    {
+        magicBytes_[i] = static_cast<uint8_t>(config_.magic_ >> (8 * i));
+    }
+    buffer_.reset(new uint8_t[capacity_]);
+}
+
+uint8_t* StreamFramer::WritePtr()
+{
+    Writable();
+    return buffer_.get() + tail_;
+}
+
+size_t StreamFramer::Writable()
+{
+    // 未成帧的数据不超过一帧，搬到缓冲区开头后至少还有一帧的空间
+    if (head_ > 0 && capacity_ - tail_ < config_.maxFrameSize_)
+    {
+        memmove(buffer_.get(), buffer_.get() + head_, tail_ - head_);
+        tail_ -= head_;
+        head_ = 0;
+    }
+    return capacity_ - tail_;
+}
+
+void StreamFramer::Commit(size_t len, const FrameHandler& handler)
+{
+    tail_ += std::min(len, capacity_ - tail_);
+
+    const size_t lengthEnd = config_.headerSize_ + sizeof(uint32_t);
+    const size_t maxLength = (config_.maxFrameSize_ - lengthEnd - config_.trailerSize_) / config_.lengthUnit_;
+    while (tail_ - head_ >= sizeof(magicBytes_))
+    {
+        const uint8_t* frame = buffer_.get() + head_;
+        const size_t available = tail_ - head_;
+        if (!IsMagic(frame))
+        {
+            Resync();
+            continue;
+        }
+        if (available < lengthEnd)
+        {
+            break;
+        }
+
+        const uint32_t length = ReadLength(frame + config_.headerSize_);
+        if (length > maxLength)
+        {
+            // 魔数出现在垃圾数据中，跳过后继续查找
+            ++head_;
+            ++discarded_;
+            continue;
+        }
+        const size_t frameLen = lengthEnd + length * config_.lengthUnit_ + config_.trailerSize_;
+        if (available < frameLen)
+        {
+            break;
+        }
+
+        FrameBuffer out = BufferPool::Instance().Acquire(frameLen);
+        memcpy(out.MutableData(), frame, frameLen);
+        head_ += frameLen;
+        ++frames_;
+        handler(out);
+    }
+
+    if (head_ == tail_)
+    {
+        head_ = tail_ = 0;
+    }
+}
+
+void StreamFramer::Feed(const uint8_t* data, size_t len, const FrameHandler& handler)
+{
+    while (len > 0)
+    {
+        const size_t count = std::min(len, Writable());
+        memcpy(WritePtr(), data, count);
+        Commit(count, handler);
+        data += count;
+        len -= count;
+    }
+}
+
+void StreamFramer::Reset()
+{
+    discarded_ += tail_ - head_;
+    head_ = tail_;
+}
+
+bool StreamFramer::IsMagic(const uint8_t* data) const
+{
+    return 0 == memcmp(data, magicBytes_, sizeof(magicBytes_));
+}
+
+uint32_t StreamFramer::ReadLength(const uint8_t* data) const
+{
+    return static_cast<uint32_t>(data[0]) | static_cast<uint32_t>(data[1]) << 8 |
+           static_cast<uint32_t>(data[2]) << 16 | static_cast<uint32_t>(data[3]) << 24;
+}
+
+void StreamFramer::Resync()
+{
+    const uint8_t* begin = buffer_.get() + head_;
+    const uint8_t* end = buffer_.get() + tail_;
+    const uint8_t* next = std::search(begin + 1, end, magicBytes_, magicBytes_ + sizeof(magicBytes_));
+    if (next == end)
+    {
+        next = std::max(begin + 1, end - (sizeof(magicBytes_) - 1));
+    }
+    discarded_ += next - begin;
+    head_ += next - begin;
+}
+
+}  // namespace aoip
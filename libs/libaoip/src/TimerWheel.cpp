@@ -0,0 +1,145 @@
+#include <algorithm>
+#include "TimerWheel.h"
+
+namespace aoip
+{
+
+TimerWheel::TimerWheel(Clock::time_point start)
+    : start_(start)
+{
+}
+
+uint64_t TimerWheel::ToTick(Clock::time_point now) const
+{
+    if (now <= start_)
+    {
+        return 0;
+    }
+    return std::chrono::duration_cast<std::chrono::milliseconds>(now - start_).count();
+}
+
+TimerWheel::Slot& TimerWheel::SlotFor(uint64_t expireTick)
+{
+    const uint64_t diff = expireTick - currentTick_;
+    for (uint32_t level = 0; level < WHEEL_LEVELS - 1; ++level)
+    {
+        if (diff < (1ull << (WHEEL_BITS * (level + 1))))
+        {
+            return wheels_[level][(expireTick >> (WHEEL_BITS * level)) & WHEEL_MASK];
+        }
+    }
+    return wheels_[WHEEL_LEVELS - 1][(expireTick >> (WHEEL_BITS * (WHEEL_LEVELS - 1))) & WHEEL_MASK];
+}
+
+uint64_t TimerWheel::Schedule(Clock::time_point now, uint32_t delayMs, TimerCallback cb)
+{
+    const uint64_t nowTick = ToTick(now);
+    // 时间轮为空时直接对齐当前时间，避免长时间空闲后刻度落后
+    if (index_.empty())
+    {
+        currentTick_ = std::max(currentTick_, nowTick);
+    }
+
+    uint64_t expireTick = std::max(nowTick + delayMs, currentTick_);
+    expireTick = std::min(expireTick, currentTick_ + MAX_DELAY_TICKS);
+
+    const uint64_t timerId = nextTimerId_++;
+    Slot& slot = SlotFor(expireTick);
+    slot.push_back(Timer{timerId, expireTick, std::move(cb)});
+    index_[timerId] = Location{&slot, std::prev(slot.end())};
+    return timerId;
+}
+
+bool TimerWheel::Cancel(uint64_t timerId)
+{
+    auto it = index_.find(timerId);
+    if (it == index_.end())
+    {
+        return false;
+    }
+    it->second.slot_->erase(it->second.it_);
+    index_.erase(it);
+    return true;
+}
+
+void TimerWheel::Place(Slot& from, Slot::iterator it)
+{
+    Slot& to = SlotFor(it->expireTick_);
+    to.splice(to.end(), from, it);
+    index_[it->id_].slot_ = &to;
+}
+
+void TimerWheel::Cascade(uint32_t level)
+{
+    const uint32_t slotIndex = (currentTick_ >> (WHEEL_BITS * level)) & WHEEL_MASK;
+    Slot pending;
+    pending.swap(wheels_[level][slotIndex]);
+    while (!pending.empty())
+    {
+        Place(pending, pending.begin());
+    }
+}
+
+void TimerWheel::Advance(Clock::time_point now, std::vector<TimerCallback>& expired)
+{
+    const uint64_t targetTick = ToTick(now);
+    while (currentTick_ <= targetTick)
+    {
+        if (index_.empty())
+        {
+            currentTick_ = targetTick + 1;
+            break;
+        }
+
+        // 低层转完一圈时，从高层逐级下放定时器
+        const uint32_t slotIndex = currentTick_ & WHEEL_MASK;
+        for (uint32_t level = 1; slotIndex == 0 && level < WHEEL_LEVELS; ++level)
+        {
+            Cascade(level);
+            if (((currentTick_ >> (WHEEL_BITS * level)) & WHEEL_MASK) != 0)
+            {
+                break;
+            }
+        }
+
+        Slot& slot = wheels_[0][slotIndex];
+        while (!slot.empty())
+        {
+            expired.push_back(std::move(slot.front().cb_));
+            index_.erase(slot.front().id_);
+            slot.pop_front();
+        }
+        ++currentTick_;
+    }
+}
+
+int TimerWheel::NextTimeoutMs(Clock::time_point now) const
+{
+    if (index_.empty())
+    {
+        return -1;
+    }
+
+    // 只扫描第 0 层到本圈结束，找不到时在下一次下放时刻唤醒；
+    // 当前刻度恰为一圈起点时，高层的下放尚未执行，需立即推进
+    const uint32_t slotIndex = currentTick_ & WHEEL_MASK;
+    const uint32_t remain = WHEEL_SLOTS - slotIndex;
+    uint64_t nextTick = (slotIndex == 0) ? currentTick_ : currentTick_ + remain;
+    for (uint32_t i = 0; slotIndex != 0 && i < remain; ++i)
+    {
+        if (!wheels_[0][(currentTick_ + i) & WHEEL_MASK].empty())
+        {
+            nextTick = currentTick_ + i;
+            break;
+        }
+    }
+
+    const auto wait = start_ + std::chrono::milliseconds(nextTick) - now;
+    if (wait <= Clock::duration::zero())
+    {
+        return 0;
+    }
+    return static_cast<int>(std::chrono::ceil<std::chrono::milliseconds>(wait).count());
+}
+
+}  // namespace aoip
@@ -0,0 +1,76 @@
+#include <algorithm>
+#include <thread>
+#include "TransportRuntime.h"
+
+namespace aoip
+{
+
+TransportRuntime::TransportRuntime(size_t ioThreads, bool pinThreads)
+{
+    reactors_.reserve(std::max<size_t>(ioThreads, 1));
+    const unsigned int cpus = std::max(std::thread::hardware_concurrency(), 1u);
+    for (size_t i = 0; i < reactors_.capacity(); ++i)
+    {
+        reactors_.push_back(std::make_shared<Reactor>());
+        if (pinThreads)
+        {
+            reactors_.back()->SetCpuAffinity(static_cast<int>(i % cpus));
+        }
+    }
+}
+
+TransportRuntime::~TransportRuntime()
+{
+    for (auto& reactor : reactors_)
+    {
+        reactor->Stop();
+    }
+}
+
+std::shared_ptr<UdpChannel> TransportRuntime::AcquireChannel(const UdpConfig& config)
+{
+    UdpConfig channelConfig = config;
+    // 同一端口上可能同时有单播和广播请求，统一开启广播
+    channelConfig.broadcast_ = true;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto key = std::make_tuple(channelConfig.bindIp_, channelConfig.bindPort_, channelConfig.peer_.Key());
+    if (channelConfig.bindPort_ != 0)
+    {
+        auto it = channels_.find(key);
+        if (it != channels_.end())
+        {
+            if (auto channel = it->second.lock())
+            {
+                return channel;
+            }
+            channels_.erase(it);
+        }
+    }
+
+    // 已连接 socket 只有一个四元组，分片没有意义
+    size_t shards = channelConfig.peer_.IsValid() ? 1 : channelConfig.receiveShards_;
+    shards = std::min(std::max<size_t>(shards, 1), reactors_.size());
+    std::vector<std::shared_ptr<Reactor>> reactors;
+    for (size_t i = 0; i < shards; ++i)
+    {
+        reactors.push_back(reactors_[nextReactor_++ % reactors_.size()]);
+        reactors.back()->Start();
+    }
+    auto channel = std::make_shared<UdpChannel>(channelConfig, reactors);
+    if (channelConfig.bindPort_ != 0)
+    {
+        channels_[key] = channel;
+    }
+    return channel;
+}
+
+std::shared_ptr<Reactor> TransportRuntime::NextReactor()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto reactor = reactors_[nextReactor_++ % reactors_.size()];
+    reactor->Start();
+    return reactor;
+}
+
+}  // namespace aoip
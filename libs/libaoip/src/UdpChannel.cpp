@@ -0,0 +1,208 @@
+#include <arpa/inet.h>
+#include <algorithm>
+#include "UdpChannel.h"
+#include "Logger.h"
+#include "code/ErrorCode.h"
+
+namespace aoip
+{
+
+UdpChannel::UdpChannel(const UdpConfig& config, std::shared_ptr<Reactor> reactor)
+    : UdpChannel(config, std::vector<std::shared_ptr<Reactor>>{reactor})
+{
+}
+
+UdpChannel::UdpChannel(const UdpConfig& config, const std::vector<std::shared_ptr<Reactor>>& reactors)
+    : reactor_(reactors.front()),
+      sinks_(std::make_shared<const SinkTable>())
+{
+    UdpConfig socketConfig = config;
+    socketConfig.reusePort_ = config.reusePort_ || reactors.size() > 1;
+    receivers_.reserve(reactors.size());
+    for (const auto& reactor : reactors)
+    {
+        Receiver receiver;
+        receiver.reactor_ = reactor;
+        receiver.socket_.reset(new UdpSocket(socketConfig));
+        receiver.ring_.reset(new DatagramRing(RECV_BATCH_SIZE, config.maxDatagramSize_));
+        // 端口由系统分配时，其余分片绑定到第一个 socket 得到的端口
+        std::string ip;
+        if (0 == socketConfig.bindPort_)
+        {
+            receiver.socket_->GetLocalAddress(ip, socketConfig.bindPort_);
+        }
+        receivers_.push_back(std::move(receiver));
+    }
+    socket_ = receivers_.front().socket_.get();
+
+    for (auto& receiver : receivers_)
+    {
+        Receiver* target = &receiver;
+        if (!receiver.socket_->SetNonBlocking(true) ||
+            !receiver.reactor_->AddHandler(receiver.socket_->GetFd(), [this, target]() { OnReadable(*target); }))
+        {
+            RUNTIME_EXCEPTION("Failed to register udp channel, port=" << socketConfig.bindPort_);
+        }
+    }
+}
+
+UdpChannel::~UdpChannel()
+{
+    for (auto& receiver : receivers_)
+    {
+        receiver.reactor_->RemoveHandler(receiver.socket_->GetFd());
+    }
+}
+
+void UdpChannel::Sync()
+{
+    for (auto& receiver : receivers_)
+    {
+        receiver.reactor_->Sync();
+    }
+}
+
+uint64_t UdpChannel::AddSink(uint32_t ip, uint16_t port, Sink sink)
+{
+    std::lock_guard<std::mutex> lock(sinkMutex_);
+    auto entry = std::make_shared<const SinkEntry>(SinkEntry{nextSinkId_++, Endpoint(ip, port).Key(), std::move(sink)});
+    auto table = std::make_shared<SinkTable>(*sinks_);
+    (*table)[entry->endpoint_].push_back(entry);
+    sinks_ = table;
+    return entry->id_;
+}
+
+void UdpChannel::RemoveSink(uint64_t sinkId)
+{
+    {
+        std::lock_guard<std::mutex> lock(sinkMutex_);
+        auto table = std::make_shared<SinkTable>(*sinks_);
+        for (auto it = table->begin(); it != table->end(); ++it)
+        {
+            auto& list = it->second;
+            auto found = std::find_if(list.begin(), list.end(), [sinkId](const auto& entry) { return entry->id_ == sinkId; });
+            if (found != list.end())
+            {
+                list.erase(found);
+                if (list.empty())
+                {
+                    table->erase(it);
+                }
+                break;
+            }
+        }
+        sinks_ = table;
+    }
+    // 等待收包线程上持有旧快照的分发结束
+    Sync();
+}
+
+bool UdpChannel::JoinGroup(const std::string& groupIp, const std::string& interfaceIp)
+{
+    std::lock_guard<std::mutex> lock(groupMutex_);
+    auto& refs = groups_[std::make_pair(groupIp, interfaceIp)];
+    if (0 == refs && !socket_->JoinGroup(groupIp, interfaceIp))
+    {
+        groups_.erase(std::make_pair(groupIp, interfaceIp));
+        return false;
+    }
+    ++refs;
+    return true;
+}
+
+void UdpChannel::LeaveGroup(const std::string& groupIp, const std::string& interfaceIp)
+{
+    std::lock_guard<std::mutex> lock(groupMutex_);
+    auto it = groups_.find(std::make_pair(groupIp, interfaceIp));
+    if (it == groups_.end())
+    {
+        return;
+    }
+    if (0 == --it->second)
+    {
+        socket_->LeaveGroup(groupIp, interfaceIp);
+        groups_.erase(it);
+    }
+}
+
+std::shared_ptr<EndpointPacer> UdpChannel::GetPacer(uint32_t ip, uint16_t port, const PacerConfig& config)
+{
+    std::lock_guard<std::mutex> lock(pacerMutex_);
+    auto& weak = pacers_[Endpoint(ip, port).Key()];
+    auto pacer = weak.lock();
+    if (!pacer)
+    {
+        pacer = std::make_shared<EndpointPacer>(config, reactor_);
+        weak = pacer;
+    }
+    return pacer;
+}
+
+bool UdpChannel::SendTo(const void* data, size_t len, const Endpoint& to)
+{
+    return socket_->SendTo(data, len, to);
+}
+
+bool UdpChannel::Broadcast(const void* data, size_t len, uint16_t port)
+{
+    return socket_->Broadcast(data, len, port);
+}
+
+size_t UdpChannel::SendBatch(const std::vector<Datagram>& datagrams)
+{
+    return socket_->SendBatch(datagrams.data(), datagrams.size());
+}
+
+void UdpChannel::OnReadable(Receiver& receiver)
+{
+    std::shared_ptr<const SinkTable> table;
+    {
+        std::lock_guard<std::mutex> lock(sinkMutex_);
+        table = sinks_;
+    }
+
+    // 突发响应一次 recvmmsg 取完，收满一批说明可能还有剩余
+    DatagramRing& ring = *receiver.ring_;
+    for (int batch = 0; batch < MAX_BATCH_PER_EVENT; ++batch)
+    {
+        const size_t count = receiver.socket_->RecvBatch(ring);
+        for (size_t i = 0; i < count; ++i)
+        {
+            const Datagram datagram = ring[i];
+            FrameBuffer frame = ring.Take(i);
+            if (frame.empty())
+            {
+                AOIP_LOG_WARN("Truncated or empty datagram dropped");
+                continue;
+            }
+            Dispatch(*table, frame, datagram.ip_, datagram.port_);
+        }
+        if (count < ring.Capacity())
+        {
+            break;
+        }
+    }
+}
+
+void UdpChannel::Dispatch(const SinkTable& table, const FrameBuffer& frame, uint32_t fromIp, uint16_t fromPort)
+{
+    // 先交给源端点的订阅者，未消费时再交给通配订阅者
+    for (const uint64_t endpoint : {Endpoint(fromIp, fromPort).Key(), Endpoint().Key()})
+    {
+        auto it = table.find(endpoint);
+        if (it == table.end())
+        {
+            continue;
+        }
+        for (const auto& entry : it->second)
+        {
+            if (entry->sink_(frame, fromIp, fromPort))
+            {
+                return;
+            }
+        }
+    }
+    AOIP_LOG_WARN("Unmatched datagram received, from=" << Endpoint(fromIp, fromPort).ToString());
+}
+
+}  // namespace aoip
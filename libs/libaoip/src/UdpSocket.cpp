@@ -5,12 +5,38 @@
 #include <sys/socket.h>
 #include <sys/types.h>
 #include <unistd.h>
+#include <algorithm>
+#include <cerrno>
 #include <cstring>
 #include "UdpSocket.h"
 #include "Logger.h"
 
 namespace aoip {
 
+Endpoint Endpoint::Resolve(const std::string& ip, uint16_t port)
+{
+    return Endpoint(inet_addr(ip.c_str()), htons(port));
+}
+
+struct sockaddr_in Endpoint::ToSockaddr() const
+{
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = port_;
+    addr.sin_addr.s_addr = ip_;
+    return addr;
+}
+
+std::string Endpoint::ToString() const
+{
+    char ip[INET_ADDRSTRLEN] = {0};
+    struct in_addr addr;
+    addr.s_addr = ip_;
+    inet_ntop(AF_INET, &addr, ip, sizeof(ip));
+    return std::string(ip) + ":" + std::to_string(ntohs(port_));
+}
+
 UdpSocket::UdpSocket(const UdpConfig& config)
  : config_(config)
  {
@@ -61,6 +87,20 @@ bool UdpSocket::Init()
         return false;
     }
 
+    // Connect to peer
+    if (config_.peer_.IsValid())
+    {
+        const struct sockaddr_in peer = config_.peer_.ToSockaddr();
+        if (connect(socket_, (const struct sockaddr*)&peer, sizeof(peer)) < 0)
+        {
+            SetError("Failed to connect socket");
+            close(socket_);
+            socket_ = -1;
+            return false;
+        }
+        connected_ = true;
+    }
+
     return true;
 }
 
@@ -74,6 +114,19 @@ bool UdpSocket::SetSocketOptions()
         return false;
     }
 
+    // Set reuse port
+    if (config_.reusePort_)
+    {
+        if (setsockopt(socket_, SOL_SOCKET, SO_REUSEPORT, &option, sizeof(option)) < 0)
+        {
+            SetError("Failed to set SO_REUSEPORT");
+            return false;
+        }
+        // 只接收本 socket 加入的组播组，避免分片 socket 各收一份
+        int multicastAll = 0;
+        setsockopt(socket_, IPPROTO_IP, IP_MULTICAST_ALL, &multicastAll, sizeof(multicastAll));
+    }
+
     // Set broadcast if enabled
     if (config_.broadcast_)
     {
@@ -117,18 +170,85 @@ bool UdpSocket::SetSocketOptions()
         return false;
     }
 
+    return SetMulticastOptions();
+}
+
+bool UdpSocket::SetMulticastOptions()
+{
+    // Set multicast TTL
+    const uint8_t ttl = config_.multicastTtl_;
+    if (setsockopt(socket_, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl)) < 0)
+    {
+        SetError("Failed to set IP_MULTICAST_TTL");
+        return false;
+    }
+
+    // Set multicast loopback
+    const uint8_t loopback = config_.multicastLoopback_ ? 1 : 0;
+    if (setsockopt(socket_, IPPROTO_IP, IP_MULTICAST_LOOP, &loopback, sizeof(loopback)) < 0)
+    {
+        SetError("Failed to set IP_MULTICAST_LOOP");
+        return false;
+    }
+
+    // Set outgoing multicast interface
+    if (!config_.multicastInterface_.empty())
+    {
+        struct in_addr iface;
+        iface.s_addr = inet_addr(config_.multicastInterface_.c_str());
+        if (setsockopt(socket_, IPPROTO_IP, IP_MULTICAST_IF, &iface, sizeof(iface)) < 0)
+        {
+            SetError("Failed to set IP_MULTICAST_IF");
+            return false;
+        }
+    }
     return true;
 }
 
-bool UdpSocket::SendTo(const void* data, size_t len, const std::string& ip, uint16_t port)
+bool UdpSocket::JoinGroup(const std::string& groupIp, const std::string& interfaceIp)
 {
-    struct sockaddr_in addr;
-    memset(&addr, 0, sizeof(addr));
-    addr.sin_family = AF_INET;
-    addr.sin_port = htons(port);
-    addr.sin_addr.s_addr = inet_addr(ip.c_str());
+    return UpdateMembership(IP_ADD_MEMBERSHIP, groupIp, interfaceIp);
+}
+
+bool UdpSocket::LeaveGroup(const std::string& groupIp, const std::string& interfaceIp)
+{
+    return UpdateMembership(IP_DROP_MEMBERSHIP, groupIp, interfaceIp);
+}
+
+bool UdpSocket::UpdateMembership(int option, const std::string& groupIp, const std::string& interfaceIp)
+{
+    struct ip_mreq mreq;
+    memset(&mreq, 0, sizeof(mreq));
+    mreq.imr_multiaddr.s_addr = inet_addr(groupIp.c_str());
+    if (!IN_MULTICAST(ntohl(mreq.imr_multiaddr.s_addr)))
+    {
+        errno = EINVAL;
+        SetError("Invalid multicast group address");
+        return false;
+    }
 
-    ssize_t sent = sendto(socket_, data, len, 0, (struct sockaddr*)&addr, sizeof(addr));
+    const std::string& iface = interfaceIp.empty() ? config_.multicastInterface_ : interfaceIp;
+    mreq.imr_interface.s_addr = iface.empty() ? htonl(INADDR_ANY) : inet_addr(iface.c_str());
+    if (setsockopt(socket_, IPPROTO_IP, option, &mreq, sizeof(mreq)) < 0)
+    {
+        SetError(IP_ADD_MEMBERSHIP == option ? "Failed to join multicast group" : "Failed to leave multicast group");
+        return false;
+    }
+    return true;
+}
+
+bool UdpSocket::SendTo(const void* data, size_t len, const Endpoint& to)
+{
+    ssize_t sent = 0;
+    if (connected_ && to == config_.peer_)
+    {
+        sent = send(socket_, data, len, 0);
+    }
+    else
+    {
+        const struct sockaddr_in addr = to.ToSockaddr();
+        sent = sendto(socket_, data, len, 0, (const struct sockaddr*)&addr, sizeof(addr));
+    }
     if (sent < 0)
     {
         SetError("Failed to send data");
@@ -152,13 +272,8 @@ bool UdpSocket::Broadcast(const void* data, size_t len, uint16_t port)
         return false;
     }
 
-    struct sockaddr_in addr;
-    memset(&addr, 0, sizeof(addr));
-    addr.sin_family = AF_INET;
-    addr.sin_port = htons(port);
-    addr.sin_addr.s_addr = INADDR_BROADCAST;
-
-    ssize_t sent = sendto(socket_, data, len, 0, (struct sockaddr*)&addr, sizeof(addr));
+    const struct sockaddr_in addr = Endpoint(INADDR_BROADCAST, htons(port)).ToSockaddr();
+    ssize_t sent = sendto(socket_, data, len, 0, (const struct sockaddr*)&addr, sizeof(addr));
     if (sent < 0)
     {
         SetError("Failed to broadcast data");
@@ -175,6 +290,21 @@ bool UdpSocket::Broadcast(const void* data, size_t len, uint16_t port)
 }
 
 bool UdpSocket::RecvFrom(void* buffer, size_t& len, std::string& fromIp, uint16_t& fromPort, int timeoutMs)
+{
+    Endpoint from;
+    if (!RecvFrom(buffer, len, from, timeoutMs))
+    {
+        return false;
+    }
+
+    struct in_addr addr;
+    addr.s_addr = from.ip_;
+    fromIp = inet_ntoa(addr);
+    fromPort = ntohs(from.port_);
+    return true;
+}
+
+bool UdpSocket::RecvFrom(void* buffer, size_t& len, Endpoint& from, int timeoutMs)
 {
     if (timeoutMs >= 0)
     {
@@ -201,20 +331,23 @@ bool UdpSocket::RecvFrom(void* buffer, size_t& len, std::string& fromIp, uint16_
     ssize_t received = recvfrom(socket_, buffer, len, 0, (struct sockaddr*)&addr, &addrLen);
     if (received < 0)
     {
+        // 非阻塞无数据或接收超时，不视为错误
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+        {
+            return false;
+        }
         SetError("Failed to receive data");
         return false;
     }
 
     len = received;
-    fromIp = inet_ntoa(addr.sin_addr);
-    fromPort = ntohs(addr.sin_port);
-
+    from = Endpoint(addr.sin_addr.s_addr, addr.sin_port);
     return true;
 }
 
 bool UdpSocket::RecvFrom(std::vector<uint8_t>& data, std::string& fromIp, uint16_t& fromPort, int timeoutMs)
 {
-    data.resize(config_.recvBufferSize_);
+    data.resize(config_.maxDatagramSize_);
     size_t len = data.size();
 
     if (!RecvFrom(data.data(), len, fromIp, fromPort, timeoutMs))
@@ -226,15 +359,165 @@ bool UdpSocket::RecvFrom(std::vector<uint8_t>& data, std::string& fromIp, uint16
     return true;
 }
 
+size_t UdpSocket::SendBatch(const Datagram* datagrams, size_t count)
+{
+    static constexpr size_t MAX_BATCH = 64;
+    struct mmsghdr headers[MAX_BATCH];
+    struct iovec iovecs[MAX_BATCH];
+    struct sockaddr_in addrs[MAX_BATCH];
+
+    size_t sent = 0;
+    while (sent < count)
+    {
+        const size_t batch = std::min(count - sent, MAX_BATCH);
+        memset(headers, 0, sizeof(struct mmsghdr) * batch);
+        for (size_t i = 0; i < batch; ++i)
+        {
+            const Datagram& datagram = datagrams[sent + i];
+            const Endpoint to(datagram.ip_, datagram.port_);
+            iovecs[i].iov_base = const_cast<void*>(datagram.data_);
+            iovecs[i].iov_len = datagram.len_;
+            // 已连接 socket 发往对端时不带地址，内核沿用连接的路由
+            if (!connected_ || to != config_.peer_)
+            {
+                addrs[i] = to.ToSockaddr();
+                headers[i].msg_hdr.msg_name = &addrs[i];
+                headers[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+            }
+            headers[i].msg_hdr.msg_iov = &iovecs[i];
+            headers[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        const int ret = sendmmsg(socket_, headers, batch, 0);
+        if (ret < 0)
+        {
+            SetError("Failed to send batch");
+            break;
+        }
+        sent += ret;
+        // 部分发送说明发送缓冲已满，剩余的交给调用方处理
+        if (static_cast<size_t>(ret) < batch)
+        {
+            break;
+        }
+    }
+    return sent;
+}
+
+size_t UdpSocket::RecvBatch(DatagramRing& ring)
+{
+    ring.Refill();
+    for (size_t i = 0; i < ring.Capacity(); ++i)
+    {
+        ring.headers_[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+        ring.headers_[i].msg_hdr.msg_flags = 0;
+    }
+
+    const int ret = recvmmsg(socket_, ring.headers_.data(), ring.Capacity(), MSG_DONTWAIT, nullptr);
+    if (ret < 0)
+    {
+        if (errno != EAGAIN && errno != EWOULDBLOCK)
+        {
+            SetError("Failed to receive batch");
+        }
+        return 0;
+    }
+
+    ring.size_ = ret;
+    return ring.size_;
+}
+
+DatagramRing::DatagramRing(size_t capacity, size_t datagramSize)
+    : datagramSize_(datagramSize),
+      frames_(capacity),
+      iovecs_(capacity),
+      addrs_(capacity),
+      headers_(capacity)
+{
+    for (size_t i = 0; i < capacity; ++i)
+    {
+        memset(&headers_[i], 0, sizeof(headers_[i]));
+        headers_[i].msg_hdr.msg_name = &addrs_[i];
+        headers_[i].msg_hdr.msg_namelen = sizeof(addrs_[i]);
+        headers_[i].msg_hdr.msg_iov = &iovecs_[i];
+        headers_[i].msg_hdr.msg_iovlen = 1;
+    }
+}
+
+void DatagramRing::Refill()
+{
+    size_ = 0;
+    for (size_t i = 0; i < frames_.size(); ++i)
+    {
+        if (frames_[i].empty())
+        {
+            frames_[i] = BufferPool::Instance().Acquire(datagramSize_);
+            iovecs_[i].iov_base = frames_[i].MutableData();
+            iovecs_[i].iov_len = datagramSize_;
+        }
+    }
+}
+
+FrameBuffer DatagramRing::Take(size_t index)
+{
+    const size_t len = (headers_[index].msg_hdr.msg_flags & MSG_TRUNC) ? 0 : headers_[index].msg_len;
+    FrameBuffer frame = std::move(frames_[index]);
+    if (len == 0)
+    {
+        // 帧保留在槽位中复用
+        frames_[index] = std::move(frame);
+        return FrameBuffer();
+    }
+    frame.Resize(len);
+    return frame;
+}
+
+Datagram DatagramRing::operator[](size_t index) const
+{
+    Datagram datagram;
+    datagram.data_ = iovecs_[index].iov_base;
+    // 被截断的数据报不完整，长度置 0 由调用方丢弃
+    datagram.len_ = (headers_[index].msg_hdr.msg_flags & MSG_TRUNC) ? 0 : headers_[index].msg_len;
+    datagram.ip_ = addrs_[index].sin_addr.s_addr;
+    datagram.port_ = addrs_[index].sin_port;
+    return datagram;
+}
+
+bool UdpSocket::SetNonBlocking(bool nonBlocking)
+{
+    int flags = fcntl(socket_, F_GETFL, 0);
+    if (flags < 0)
+    {
+        SetError("Failed to get socket flags");
+        return false;
+    }
+
+    flags = nonBlocking ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK);
+    if (fcntl(socket_, F_SETFL, flags) < 0)
+    {
+        SetError("Failed to set O_NONBLOCK");
+        return false;
+    }
+    return true;
+}
+
 void UdpSocket::SetError(const char* msg)
 {
-    lastError_ = msg;
+    std::string error = msg;
     if (errno != 0)
     {
-        lastError_ += ": ";
-        lastError_ += strerror(errno);
+        error += ": ";
+        error += strerror(errno);
     }
-    AOIP_LOG_ERROR(lastError_);
+    AOIP_LOG_ERROR(error);
+    std::lock_guard<std::mutex> lock(errorMutex_);
+    lastError_ = std::move(error);
+}
+
+std::string UdpSocket::GetLastError() const
+{
+    std::lock_guard<std::mutex> lock(errorMutex_);
+    return lastError_;
 }
 
 bool UdpSocket::GetLocalAddress(std::string& ip, uint16_t& port) const
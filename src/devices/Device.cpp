@@ -4,7 +4,12 @@
 
 Device::Device(const DeviceNetworkInfo& info)
     : controller_(DeviceController::CreateDeviceController(info))
-{}
+{
+    if (controller_)
+    {
+        controller_->Init();
+    }
+}
 
 Device::Device(const std::shared_ptr<Device>&device)
     : controller_(device->controller_)
@@ -32,26 +32,54 @@ DeviceDiscoveryProcessor::~DeviceDiscoveryProcessor()
     }
 }
 
-void DeviceDiscoveryProcessor::OnRecvResponse(const std::vector<uint8_t>& data)
+void DeviceDiscoveryProcessor::OnRecvResponse(const aoip::FrameBuffer& data)
 {
-    const auto functionCode = GetFunctionCodeByData(data);
-    LOG_INFO_THIS("recv response function code=" << functionCode);
+    // 未匹配在途请求的帧（如请求已超时后才到达的响应）
+    const FrameHeaderView header(data.data(), data.size());
+    if (!header.Valid())
+    {
+        LOG_WARNING_THIS("invalid frame header, size=" << data.size());
+        return;
+    }
+    const auto functionCode = header.GetFunctionCode();
+    LOG_INFO_THIS("recv response function code=" << functionCode << "(" << GetFunctionCodeName(functionCode) << ")");
     if (FunctionCode::PL_FUN_NETINFO_GET == FunctionCode(functionCode))
     {
-        McuNetInfoGetResponseMsg msg;
-        msg.DeserializeBody(Binary::Unpack(data.data(), data.size()));
-        LOG_DEBUG_THIS("mac=" << MacToString(msg.netInfo_.mac_) << ", ip=" << IpToString(msg.netInfo_.ip_) << ", mask=" << IpToString(msg.netInfo_.mask_) << ", gw=" << IpToString(msg.netInfo_.gw_));
-        if (discoverOb_.lock())
-        {
-            DeviceNetworkInfo networkInfo;
-            networkInfo.deviceType   = DeviceType::PAT71;
-            networkInfo.deviceVendor = DeviceVendor::KINGRAY;
-            networkInfo.deviceId     = 201;
-            networkInfo.unicastIp    = IpToString(msg.netInfo_.ip_);
-            networkInfo.unicastPort  = 50000;
+        HandleNetInfoResponse(data);
+    }
+}
 
-            discoverOb_.lock()->OnUpdateDeviceStatus(networkInfo, true);
-        }
+bool DeviceDiscoveryProcessor::GetFunctionCode(const aoip::FrameBuffer& response, uint16_t& functionCode) const
+{
+    uint32_t sequence = 0;
+    return GetCorrelationKeyByData(response.data(), response.size(), functionCode, sequence);
+}
+
+bool DeviceDiscoveryProcessor::GetCorrelationKey(const aoip::FrameBuffer& response, uint16_t& functionCode, uint32_t& sequence) const
+{
+    return GetCorrelationKeyByData(response.data(), response.size(), functionCode, sequence);
+}
+
+void DeviceDiscoveryProcessor::HandleNetInfoResponse(const aoip::FrameBuffer& data)
+{
+    // 整帧包括消息头，格式或校验和错误的帧丢弃
+    McuNetInfoGetResponseMsg msg;
+    if (!msg.Deserialize(Binary::Unpack(data.data(), data.size())))
+    {
+        LOG_WARNING_THIS("invalid net info response, size=" << data.size());
+        return;
+    }
+    LOG_DEBUG_THIS("mac=" << MacToString(msg.netInfo_.mac_) << ", ip=" << IpToString(msg.netInfo_.ip_) << ", mask=" << IpToString(msg.netInfo_.mask_) << ", gw=" << IpToString(msg.netInfo_.gw_));
+    if (discoverOb_.lock())
+    {
+        DeviceNetworkInfo networkInfo;
+        networkInfo.deviceType   = DeviceType::PAT71;
+        networkInfo.deviceVendor = DeviceVendor::KINGRAY;
+        networkInfo.deviceId     = 201;
+        networkInfo.unicastIp    = IpToString(msg.netInfo_.ip_);
+        networkInfo.unicastPort  = 50000;
+
+        discoverOb_.lock()->OnUpdateDeviceStatus(networkInfo, true);
     }
 }
 
@@ -70,7 +98,7 @@ void DeviceDiscoveryProcessor::DeviceDiscoveryRequest()
         {
             CreateSerialConnection();
         }
-        // 创建成功，向串口发送请求
+        // 创建成功，向串口发送请求；与 UDP 相同按 (功能号, 设备ID) 关联响应，上一轮未完成时合并
         if (serialConnection_)
         {
             Binary::Pack pack;
@@ -80,7 +108,23 @@ void DeviceDiscoveryProcessor::DeviceDiscoveryRequest()
             if (serializeResult)
             {
                 LOG_INFO_THIS("send get mcu network info request");
-                serialConnection_->Write(pack.data(), pack.size());
+                std::weak_ptr<DeviceDiscoveryProcessor> weakThis = shared_from_this();
+                try
+                {
+                    serialConnection_->SendRequest(request.messageHeader_.functionCode_, request.messageHeader_.deviceID_, pack.data(), pack.size(),
+                        [weakThis](const aoip::FrameBuffer& response, std::exception_ptr error)
+                        {
+                            auto self = weakThis.lock();
+                            if (self && !error)
+                            {
+                                self->HandleNetInfoResponse(response);
+                            }
+                        });
+                }
+                catch (const std::exception& e)
+                {
+                    LOG_ERROR_THIS("send get mcu network info request fail! reason=" << e.what());
+                }
             }
         }
     }
@@ -97,6 +141,7 @@ void DeviceDiscoveryProcessor::CreateSerialConnection()
         }
         if (serialConnection_)
         {
+            serialConnection_->SetCorrelationCallback(std::dynamic_pointer_cast<aoip::UdpCallback>(shared_from_this()));
             serialConnection_->Start();
         }
     }
@@ -6,9 +6,9 @@ DigisynController::DigisynController(const DeviceNetworkInfo& info)
 
 }
 
-std::string DigisynController::GetFunctionCode(const std::vector<uint8_t>& response) const
+bool DigisynController::GetFunctionCode(const aoip::FrameBuffer& response, uint16_t& functionCode) const
 {
-    return "";
+    return false;
 }
 
 std::string DigisynController::GetDeviceName(const std::string& deviceId) const
@@ -61,110 +61,225 @@ void CommonMessage::DeserializeHeader(const Binary::Unpack& unpack)
 
 void McuNetInfoGetResponseMsg::DeserializeBody(const Binary::Unpack& unpack)
 {
-    uint32_t checksum = 0;
-    uint32_t dataLen = 0;
-    unpack >> dataLen;
-    const auto sum = CalculateChecksum(dataLen, reinterpret_cast<const uint32_t*>(unpack.data()));
-    Binary::ReadArray(unpack, netInfo_.mac_, sizeof(netInfo_.mac_));
-    Binary::ReadArray(unpack, netInfo_.ip_, sizeof(netInfo_.ip_));
-    Binary::ReadArray(unpack, netInfo_.mask_, sizeof(netInfo_.mask_));
-    Binary::ReadArray(unpack, netInfo_.gw_, sizeof(netInfo_.gw_));
-    unpack >> netInfo_.dhcpMode_ >> netInfo_.reserve_  >> checksum;
-    // 验证检验和
-    VerifyChecksum(sum, checksum);
+    KingrayLayout::UnpackBody(unpack, netInfo_);
 }
 
 void McuNetInfoSetRequestMsg::SerializeBody(Binary::Pack& pack)
 {
-    // 消息体大小
-    const uint32_t dataLen = sizeof(netInfo_) / sizeof(uint32_t);
-    pack << dataLen;
-    const auto bodySize = pack.size();
-    // 消息体
-    WriteArray(pack, netInfo_.mac_, sizeof(netInfo_.mac_));
-    WriteArray(pack, netInfo_.ip_, sizeof(netInfo_.ip_));
-    WriteArray(pack, netInfo_.mask_, sizeof(netInfo_.mask_));
-    WriteArray(pack, netInfo_.gw_, sizeof(netInfo_.gw_));
-    pack << netInfo_.dhcpMode_ << netInfo_.reserve_;
-    // 计算校验和
-    pack << CalculateChecksum(dataLen, reinterpret_cast<const uint32_t*>(pack.data() + bodySize));
+    KingrayLayout::PackBody(pack, netInfo_);
 }
 
 void DeviceMarkRequestMsg::SerializeBody(Binary::Pack& pack)
 {
-    // 消息体大小，这里以 action_、deviceType_ 和 deviceCode_ 的总字节数作为数据长度
-    const uint32_t dataLen = sizeof(deviceMark_) / sizeof(uint32_t);
-    pack << dataLen;
-    const auto bodySize = pack.size();
-    // 消息体
-    pack << deviceMark_.action_ << deviceMark_.deviceType_ << deviceMark_.deviceCode_;
-    // 计算校验和
-    pack << CalculateChecksum(dataLen, reinterpret_cast<const uint32_t*>(pack.data() + bodySize));
+    KingrayLayout::PackBody(pack, deviceMark_);
+}
+
+void GroupCodeGetResponseMsg::DeserializeBody(const Binary::Unpack& unpack)
+{
+    KingrayLayout::UnpackBody(unpack, groupInfo_);
+}
+
+void GroupCodeSetRequestMsg::SerializeBody(Binary::Pack& pack)
+{
+    KingrayLayout::PackBody(pack, groupInfo_);
+}
+
+void MeetingParamGetResponsetMsg::DeserializeBody(const Binary::Unpack& unpack)
+{
+    KingrayLayout::UnpackBody(unpack, meetingParam_);
+}
+
+void MeetingParamSetRequestMsg::SerializeBody(Binary::Pack& pack)
+{
+    KingrayLayout::PackBody(pack, meetingParam_);
+}
+
+void WlMicFreqAllowSetRequestMsg::SerializeBody(Binary::Pack& pack)
+{
+    KingrayLayout::PackBody(pack, freqAllowInfo_);
+}
+
+void PairModeGetResponseMsg::DeserializeBody(const Binary::Unpack& unpack)
+{
+    KingrayLayout::UnpackBody(unpack, pairModeInfo_);
+}
+
+void PairModeSetRequestMsg::SerializeBody(Binary::Pack& pack)
+{
+    KingrayLayout::PackBody(pack, pairModeInfo_);
+}
+
+void ManualPairingSetRequestMsg::SerializeBody(Binary::Pack& pack)
+{
+    KingrayLayout::PackBody(pack, manualPairingInfo_);
+}
+
+void DeviceRemoveRequestMsg::SerializeBody(Binary::Pack& pack)
+{
+    KingrayLayout::PackBody(pack, deviceCodeInfo_);
+}
+
+void SingleDevVolSetRequestMsg::SerializeBody(Binary::Pack& pack)
+{
+    KingrayLayout::PackBody(pack, singleDevVolumeInfo_);
+}
+
+// 以设备类型查询全部设备的请求，消息体均为 DeviceTypeBaseInfo
+void CodeReassignSetRequestMsg::SerializeBody(Binary::Pack& pack)
+{
+    KingrayLayout::PackBody(pack, deviceTypeInfo_);
+}
+
+void RestoreFactorySetRequestMsg::SerializeBody(Binary::Pack& pack)
+{
+    KingrayLayout::PackBody(pack, deviceTypeInfo_);
+}
+
+void AesModuleInfoGetRequestMsg::SerializeBody(Binary::Pack& pack)
+{
+    KingrayLayout::PackBody(pack, deviceTypeInfo_);
+}
+
+void MeetingDeviceCodeGetRequestMsg::SerializeBody(Binary::Pack& pack)
+{
+    KingrayLayout::PackBody(pack, deviceTypeInfo_);
 }
 
 void MicIdTypeGetRequestMsg::SerializeBody(Binary::Pack& pack)
 {
-    // 消息体大小，这里以 deviceType_ 和 reserve_ 数组的总字节数作为数据长度
-    const uint32_t dataLen = sizeof(deviceTypeInfo_) / sizeof(uint32_t);
-    pack << dataLen;
-    const auto bodySize = pack.size();
+    KingrayLayout::PackBody(pack, deviceTypeInfo_);
+}
 
-    // 消息体
-    pack << deviceTypeInfo_.deviceType_;
-    for (int i = 0; i < sizeof(deviceTypeInfo_.reserve_) / sizeof(deviceTypeInfo_.reserve_[0]); ++i) {
-        pack << deviceTypeInfo_.reserve_[i];
-    }
+void AllMicSpeakerVolGetRequestMsg::SerializeBody(Binary::Pack& pack)
+{
+    KingrayLayout::PackBody(pack, deviceTypeInfo_);
+}
 
-    // 计算校验和
-    pack << CalculateChecksum(dataLen, reinterpret_cast<const uint32_t*>(pack.data() + bodySize));
+void AllMicSpeakerVerGetRequestMsg::SerializeBody(Binary::Pack& pack)
+{
+    KingrayLayout::PackBody(pack, deviceTypeInfo_);
 }
 
-void MicIdTypeGetResponseMsg::DeserializeBody(const Binary::Unpack& unpack)
+void MeetingDevClockStatusGetRequestMsg::SerializeBody(Binary::Pack& pack)
+{
+    KingrayLayout::PackBody(pack, deviceTypeInfo_);
+}
+
+void MeetingDevNetStatusGetRequestMsg::SerializeBody(Binary::Pack& pack)
+{
+    KingrayLayout::PackBody(pack, deviceTypeInfo_);
+}
+
+void MeetingDevEventStatusGetRequestMsg::SerializeBody(Binary::Pack& pack)
+{
+    KingrayLayout::PackBody(pack, deviceTypeInfo_);
+}
+
+void AllWlWdSpeakerTypeGetRequestMsg::SerializeBody(Binary::Pack& pack)
+{
+    KingrayLayout::PackBody(pack, deviceTypeInfo_);
+}
+
+void AllMicSpeakerDevNameGetRequestMsg::SerializeBody(Binary::Pack& pack)
 {
-    uint32_t checksum = 0;
-    uint32_t dataLen = 0;
+    KingrayLayout::PackBody(pack, deviceTypeInfo_);
+}
+
+void AllDeviceOnlineGetRequestMsg::SerializeBody(Binary::Pack& pack)
+{
+    KingrayLayout::PackBody(pack, deviceTypeInfo_);
+}
+
+void AllDeviceChannelConfigGetRequestMsg::SerializeBody(Binary::Pack& pack)
+{
+    KingrayLayout::PackBody(pack, deviceTypeInfo_);
+}
 
-    // 读取数据长度
-    unpack >> dataLen;
+void MicIdTypeGetResponseMsg::DeserializeBody(const Binary::Unpack& unpack)
+{
+    const KingrayLayout::BodyView body(unpack);
+    body.Read(0, deviceType_);
+    const auto records = GetIdTypeInfos(body);
+    idTypeInfoVec_.assign(records.begin(), records.end());
+}
 
-    // 获取数据指针
-    const uint32_t* dataPtr = reinterpret_cast<const uint32_t*>(unpack.data());
+KingrayLayout::RecordRange<MicIdTypeGetResponseMsg::IdTypeInfo> MicIdTypeGetResponseMsg::GetIdTypeInfos(
+    const KingrayLayout::BodyView& body)
+{
+    return body.Records<IdTypeInfo>(DEVICE_RECORDS_OFFSET);
+}
 
-    // 计算校验和
-    uint32_t sum = CalculateChecksum(dataLen, dataPtr);
+void AllMicSpeakerVolGetResponseMsg::DeserializeBody(const Binary::Unpack& unpack)
+{
+    const KingrayLayout::BodyView body(unpack);
+    body.Read(0, deviceType_);
+    body.Read(1, reserve_);
+    const auto records = GetVolumeInfos(body);
+    volumeInfoVec_.assign(records.begin(), records.end());
+}
 
-    // 读取 deviceType_
-    unpack >> deviceType_;
-    deviceType_*=4;
+KingrayLayout::RecordRange<AllMicSpeakerVolGetResponseMsg::VolumeInfo> AllMicSpeakerVolGetResponseMsg::GetVolumeInfos(
+    const KingrayLayout::BodyView& body)
+{
+    return body.Records<VolumeInfo>(DEVICE_RECORDS_OFFSET);
+}
 
-    const uint16_t idTypeInfoCount = (dataLen - sizeof(uint8_t) - sizeof(deviceType_)) / sizeof(IdTypeInfo);
+void AllWlWdSpeakerTypeGetResponseMsg::DeserializeBody(const Binary::Unpack& unpack)
+{
+    const KingrayLayout::BodyView body(unpack);
+    body.Read(0, deviceType_);
+    body.Read(1, reserve_);
+    const auto records = GetDetailInfos(body);
+    detailInfoVec_.assign(records.begin(), records.end());
+}
 
-    idTypeInfoVec_.clear();
+KingrayLayout::RecordRange<AllWlWdSpeakerTypeGetResponseMsg::DetailInfo> AllWlWdSpeakerTypeGetResponseMsg::GetDetailInfos(
+    const KingrayLayout::BodyView& body)
+{
+    return body.Records<DetailInfo>(DEVICE_RECORDS_OFFSET);
+}
 
-    // 读取每个 IdTypeInfo 结构体
-    for (uint16_t i = 0; i < idTypeInfoCount; ++i) {
-        IdTypeInfo idTypeInfo;
-        unpack >> idTypeInfo.deviceCode_;
-        unpack >> idTypeInfo.idType_;
-        idTypeInfoVec_.push_back(idTypeInfo);
+void AllMicSpeakerDevNameResponseMsg::DeserializeBody(const Binary::Unpack& unpack)
+{
+    const KingrayLayout::BodyView body(unpack);
+    body.Read(0, deviceType_);
+    body.Read(1, reserve_);
+    const auto records = GetNameInfos(body);
+    nameInfoVec_.clear();
+    nameInfoVec_.reserve(records.size());
+    for (const auto& record : records)
+    {
+        nameInfoVec_.push_back({record.deviceCode_, std::string(record.name_)});
     }
+}
 
-    // 读取校验和
-    unpack >> checksum;
+KingrayLayout::RecordRange<AllMicSpeakerDevNameResponseMsg::NameInfoView> AllMicSpeakerDevNameResponseMsg::GetNameInfos(
+    const KingrayLayout::BodyView& body)
+{
+    return body.Records<NameInfoView>(DEVICE_RECORDS_OFFSET);
+}
 
-    // 验证检验和
-    VerifyChecksum(sum, checksum);
+void AllDeviceOnlineResponseMsg::DeserializeBody(const Binary::Unpack& unpack)
+{
+    const KingrayLayout::BodyView body(unpack);
+    body.Read(0, deviceType_);
+    body.Read(1, reserve_);
+    const auto records = GetOnlineInfos(body);
+    onlineInfoVec_.assign(records.begin(), records.end());
+}
+
+KingrayLayout::RecordRange<AllDeviceOnlineResponseMsg::OnlineInfo> AllDeviceOnlineResponseMsg::GetOnlineInfos(
+    const KingrayLayout::BodyView& body)
+{
+    return body.Records<OnlineInfo>(DEVICE_RECORDS_OFFSET);
 }
 
 void SingleDeviceNameGetResponseMsg::DeserializeBody(const Binary::Unpack& unpack)
 {
-    uint32_t checksum = 0;
-    uint32_t dataLen = 0;
-    unpack >> dataLen;
-    const auto sum = CalculateChecksum(dataLen, reinterpret_cast<const uint32_t*>(unpack.data()));
-    uint32_t temp[6] = {0};
-    ReadArray(unpack, temp, sizeof(temp));
-    // 验证检验和
-    VerifyChecksum(sum, checksum);
-    name_ = StringUtils::Split(temp, sizeof(temp), ' ');
+    // dataLen 与帧长和校验和在 BodyView 中校验，不会越界读取
+    const KingrayLayout::BodyView body(unpack);
+    uint8_t name[NAME_SIZE] = {0};
+    body.Read(0, name);
+    const auto nameSize = strnlen(reinterpret_cast<const char*>(name), sizeof(name));
+    name_ = StringUtils::Split(name, static_cast<uint32_t>(nameSize), ' ');
 }
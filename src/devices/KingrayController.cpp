@@ -3,7 +3,10 @@
 
 KingrayController::KingrayController(const DeviceNetworkInfo& info)
     : DeviceController(info)
-      
+{
+}
+
+void KingrayController::Init()
 {
     InitTransport();
 }
@@ -14,6 +17,13 @@ void KingrayController::InitTransport()
     config.masterIp_ = networkInfo_.unicastIp;
     config.masterPort_ = networkInfo_.unicastPort;
     config.broadcast_ = false;
+    // 设备配置了组播地址时加入该组，接收状态流，并可用一次组播控制整组设备
+    if (!networkInfo_.multicastIp.empty())
+    {
+        config.multicastIp_ = networkInfo_.multicastIp;
+        config.multicastPort_ = networkInfo_.multicastPort;
+    }
+    // 所有控制器共享 TransportRuntime 的 I/O 线程和本地端口
     transport_.reset(new aoip::AsyncProtocol(config));
     if (transport_)
     {
@@ -22,29 +32,70 @@ void KingrayController::InitTransport()
     }
 }
 
-std::string KingrayController::GetFunctionCode(const std::vector<uint8_t>& response) const
+bool KingrayController::GetFunctionCode(const aoip::FrameBuffer& response, uint16_t& functionCode) const
 {
-    const auto functionCode = GetFunctionCodeByData(response);
-    return GetFunctionCodeStr(functionCode);
+    uint32_t sequence = 0;
+    return GetCorrelationKeyByData(response.data(), response.size(), functionCode, sequence);
+}
+
+bool KingrayController::GetCorrelationKey(const aoip::FrameBuffer& response, uint16_t& functionCode, uint32_t& sequence) const
+{
+    // 只读取消息头，以 (功能号, 设备ID) 作为关联键
+    return GetCorrelationKeyByData(response.data(), response.size(), functionCode, sequence);
 }
 
 std::string KingrayController::GetDeviceName(const std::string& deviceId) const
 {
     Binary::Pack pack;
     SingleDeviceNameGetRequestMsg request;
-    const auto serializeResult = request.Serialize(pack);
-    if (transport_ && serializeResult)
+    if (!transport_ || !request.Serialize(pack))
     {
-        std::future<std::vector<uint8_t>> future = transport_->SendRequest(GetFunctionCodeStr(request.messageHeader_.functionCode_), pack.data(), pack.size());
-        std::vector<uint8_t> response = future.get();
-        Binary::Unpack unpack(response.data(), response.size());
+        return "";
+    }
 
+    // 调用方阻塞等待，最长为超时和重传的总时长，不能在传输层回调中调用；按交互优先级发送，不排在后台轮询之后
+    try
+    {
+        std::future<aoip::FrameBuffer> future = transport_->SendRequest(request.messageHeader_.functionCode_, request.messageHeader_.deviceID_,
+                                                                        pack.data(), pack.size(), aoip::RequestPriority::INTERACTIVE);
+        // 响应帧直接从接收缓冲池交给调用方，不复制；整帧包括消息头，格式错误时按空名称返回
+        aoip::FrameBuffer response = future.get();
         SingleDeviceNameGetResponseMsg responseMsg;
-        responseMsg.DeserializeBody(unpack);
-        return responseMsg.name_;
-        
+        if (responseMsg.Deserialize(Binary::Unpack(response.data(), response.size())))
+        {
+            return responseMsg.name_;
+        }
     }
-     return "";
+    catch (const std::exception&)
+    {
+        // 超时、协议未启动或与在途请求冲突时与异步接口一样按空名称返回，不向调用方抛出
+    }
+    return "";
+}
+
+void KingrayController::AsyncGetDeviceName(const std::string& deviceId, DeviceNameHandler handler) const
+{
+    Binary::Pack pack;
+    SingleDeviceNameGetRequestMsg request;
+    if (!transport_ || !request.Serialize(pack))
+    {
+        handler("");
+        return;
+    }
+
+    // 回调在传输层线程执行，不占用调用线程等待响应
+    transport_->SendRequest(request.messageHeader_.functionCode_, request.messageHeader_.deviceID_, pack.data(), pack.size(),
+        [handler](const aoip::FrameBuffer& response, std::exception_ptr error)
+        {
+            // 整帧包括消息头，长度和校验和在解析时校验，解析失败按空名称返回
+            SingleDeviceNameGetResponseMsg responseMsg;
+            if (!error && responseMsg.Deserialize(Binary::Unpack(response.data(), response.size())))
+            {
+                handler(responseMsg.name_);
+                return;
+            }
+            handler("");
+        });
 }
 
 DeviceAddress KingrayController::GetDeviceAddress(const std::string& deviceId) const
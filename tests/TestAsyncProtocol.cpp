@@ -0,0 +1,39 @@
+#include <catch2/catch.hpp>
+#include "AsyncProtocol.h"
+
+using namespace aoip;
+
+TEST_CASE("Sharded channels reject broadcast protocols and subscriptions", "[AsyncProtocol]") {
+    TransportRuntime runtime(2);
+    ProtocolConfig config;
+    config.slavePort_ = 0;
+    config.receiveShards_ = 2;
+    config.broadcast_ = true;
+    // 通配端点会从多个接收线程收到帧
+    REQUIRE_THROWS(AsyncProtocol(config, runtime));
+
+    config.broadcast_ = false;
+    config.masterIp_ = "127.0.0.1";
+    AsyncProtocol sharded(config, runtime);
+    REQUIRE_THROWS(sharded.Subscribe());
+
+    config.receiveShards_ = 1;
+    AsyncProtocol single(config, runtime);
+    REQUIRE(single.Subscribe() != nullptr);
+}
+
+TEST_CASE("Batch items without a protocol fail alone", "[AsyncProtocol]") {
+    const uint8_t data[4] = {0};
+    std::exception_ptr handlerError;
+    std::vector<BatchRequest> requests(2);
+    requests[0].data_ = data;
+    requests[0].len_ = sizeof(data);
+    requests[1] = requests[0];
+    requests[1].handler_ = [&handlerError](const FrameBuffer&, std::exception_ptr error) { handlerError = error; };
+
+    auto futures = AsyncProtocol::SendRequests(requests);
+    REQUIRE(futures.size() == 2);
+    REQUIRE_THROWS(futures[0].get());
+    REQUIRE_FALSE(futures[1].valid());
+    REQUIRE(handlerError != nullptr);
+}
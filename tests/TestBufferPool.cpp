@@ -0,0 +1,50 @@
+#include <catch2/catch.hpp>
+#include <cstring>
+#include "BufferPool.h"
+
+using namespace aoip;
+
+TEST_CASE("An exhausted pool falls back to the heap", "[BufferPool]") {
+    BufferPool pool(2, 64);
+    auto first = pool.Acquire(10);
+    auto second = pool.Acquire(10);
+    REQUIRE(pool.Available() == 0);
+
+    auto heap = pool.Acquire(10);
+    REQUIRE(heap.size() == 10);
+    REQUIRE(heap.Capacity() >= 10);
+    memset(heap.MutableData(), 0xAB, heap.size());
+    heap = FrameBuffer();
+    REQUIRE(pool.Available() == 0);
+
+    first = FrameBuffer();
+    REQUIRE(pool.Available() == 1);
+}
+
+TEST_CASE("Oversized frames are allocated on the heap", "[BufferPool]") {
+    BufferPool pool(1, 64);
+    auto frame = pool.Acquire(100);
+    REQUIRE(frame.size() == 100);
+    REQUIRE(frame.Capacity() >= 100);
+    REQUIRE(pool.Available() == 1);
+}
+
+TEST_CASE("Copies and slices share the frame until the last one is released", "[BufferPool]") {
+    BufferPool pool(1, 64);
+    auto frame = pool.Acquire(8);
+    for (uint8_t i = 0; i < 8; ++i)
+    {
+        frame.MutableData()[i] = i;
+    }
+    auto slice = frame.Slice(2, 4);
+    const FrameBuffer copy = frame;
+    REQUIRE(slice.data() == frame.data() + 2);
+    REQUIRE(copy.data() == frame.data());
+    REQUIRE_THROWS(frame.Slice(6, 4));
+
+    frame = FrameBuffer();
+    REQUIRE(pool.Available() == 0);
+    REQUIRE(slice.data()[0] == 2);
+    slice = FrameBuffer();
+    REQUIRE(pool.Available() == 0);
+}
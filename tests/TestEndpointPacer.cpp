@@ -0,0 +1,117 @@
+#include <catch2/catch.hpp>
+#include <atomic>
+#include "EndpointPacer.h"
+#include "TestUtils.h"
+
+using namespace aoip;
+
+namespace
+{
+
+std::shared_ptr<EndpointPacer> MakePacer(const PacerConfig& config, std::shared_ptr<Reactor> reactor)
+{
+    return std::make_shared<EndpointPacer>(config, reactor);
+}
+
+}  // namespace
+
+TEST_CASE("The default pacer config admits everything", "[EndpointPacer]") {
+    REQUIRE(PacerConfig().Unlimited());
+    REQUIRE_FALSE((PacerConfig{1, 0, 0}).Unlimited());
+
+    auto reactor = std::make_shared<Reactor>();
+    auto pacer = MakePacer(PacerConfig(), reactor);
+    int owner = 0;
+    for (int i = 0; i < 1000; ++i)
+    {
+        REQUIRE(pacer->Admit(&owner, RequestPriority::BACKGROUND, nullptr));
+    }
+    REQUIRE(pacer->GetMetrics().throttled_ == 0);
+}
+
+TEST_CASE("The in-flight window queues requests until a slot is released", "[EndpointPacer]") {
+    auto reactor = std::make_shared<Reactor>();
+    auto pacer = MakePacer(PacerConfig{2, 0, 0}, reactor);
+    int owner = 0;
+    bool queuedRan = false;
+
+    REQUIRE(pacer->Admit(&owner, RequestPriority::NORMAL, nullptr));
+    REQUIRE(pacer->Admit(&owner, RequestPriority::NORMAL, nullptr));
+    REQUIRE_FALSE(pacer->Admit(&owner, RequestPriority::NORMAL, [&queuedRan]() { queuedRan = true; }));
+    REQUIRE(pacer->GetMetrics().inFlight_ == 2);
+    REQUIRE(pacer->GetMetrics().pending_ == 1);
+
+    pacer->Release();
+    REQUIRE(queuedRan);
+    REQUIRE(pacer->GetMetrics().inFlight_ == 2);
+    REQUIRE(pacer->GetMetrics().throttled_ == 1);
+}
+
+TEST_CASE("The token bucket limits the send rate", "[EndpointPacer]") {
+    auto reactor = std::make_shared<Reactor>();
+    reactor->Start();
+    // 20 个/秒，容量 2：前两个立即放行，第三个约 50ms 后由定时器放行
+    auto pacer = MakePacer(PacerConfig{0, 20, 2}, reactor);
+    int owner = 0;
+    std::atomic<bool> queuedRan{false};
+
+    REQUIRE(pacer->Admit(&owner, RequestPriority::NORMAL, nullptr));
+    REQUIRE(pacer->Admit(&owner, RequestPriority::NORMAL, nullptr));
+    const auto queuedAt = std::chrono::steady_clock::now();
+    REQUIRE_FALSE(pacer->Admit(&owner, RequestPriority::NORMAL, [&queuedRan]() { queuedRan = true; }));
+
+    REQUIRE(TestUtils::WaitFor([&queuedRan]() { return queuedRan.load(); }));
+    REQUIRE(std::chrono::steady_clock::now() - queuedAt >= std::chrono::milliseconds(40));
+    reactor->Stop();
+}
+
+TEST_CASE("Background requests cannot take the reserved slot", "[EndpointPacer]") {
+    auto reactor = std::make_shared<Reactor>();
+    auto pacer = MakePacer(PacerConfig{2, 0, 0}, reactor);
+    int owner = 0;
+
+    REQUIRE(pacer->Admit(&owner, RequestPriority::BACKGROUND, nullptr));
+    REQUIRE_FALSE(pacer->Admit(&owner, RequestPriority::BACKGROUND, []() {}));
+    REQUIRE(pacer->Admit(&owner, RequestPriority::INTERACTIVE, nullptr));
+}
+
+TEST_CASE("Queued requests are released in priority order and can be cancelled", "[EndpointPacer]") {
+    auto reactor = std::make_shared<Reactor>();
+    auto pacer = MakePacer(PacerConfig{1, 0, 0}, reactor);
+    int owner = 0;
+    std::vector<RequestPriority> order;
+    int other = 0;
+
+    REQUIRE(pacer->Admit(&owner, RequestPriority::NORMAL, nullptr));
+    pacer->Admit(&owner, RequestPriority::BACKGROUND, [&order]() { order.push_back(RequestPriority::BACKGROUND); });
+    pacer->Admit(&owner, RequestPriority::INTERACTIVE, [&order]() { order.push_back(RequestPriority::INTERACTIVE); });
+    pacer->Admit(&other, RequestPriority::INTERACTIVE, [&order]() { order.push_back(RequestPriority::NORMAL); });
+    REQUIRE(pacer->Cancel(&other) == 1);
+
+    pacer->Release();
+    pacer->Release();
+    REQUIRE(order == std::vector<RequestPriority>{RequestPriority::INTERACTIVE, RequestPriority::BACKGROUND});
+}
+
+TEST_CASE("Cancel waits for a task another thread has already dequeued", "[EndpointPacer]") {
+    auto reactor = std::make_shared<Reactor>();
+    auto pacer = MakePacer(PacerConfig{1, 0, 0}, reactor);
+    int first = 0;
+    int second = 0;
+    std::atomic<bool> started{false};
+    std::atomic<bool> finished{false};
+
+    REQUIRE(pacer->Admit(&first, RequestPriority::NORMAL, nullptr));
+    REQUIRE_FALSE(pacer->Admit(&second, RequestPriority::NORMAL, [&started, &finished]() {
+        started = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        finished = true;
+    }));
+
+    // first 释放窗口时在本线程之外执行 second 的任务
+    std::thread releaser([&pacer]() { pacer->Release(); });
+    REQUIRE(TestUtils::WaitFor([&started]() { return started.load(); }));
+    REQUIRE(pacer->Cancel(&second) == 0);
+    REQUIRE(finished);
+    releaser.join();
+}
@@ -0,0 +1,71 @@
+#include <catch2/catch.hpp>
+#include <future>
+#include "KingraySimulator.h"
+#include "devices/KingrayController.h"
+#include "TestUtils.h"
+
+using TestUtils::MakeKingrayFrame;
+
+namespace
+{
+
+struct SimulatorFixture
+{
+    SimulatorFixture()
+    {
+        SimulatorConfig config;
+        config.udpPort_ = 0;
+        config.deviceCount_ = 4;
+        config.latencyMs_ = 0;
+        config.jitterMs_ = 0;
+        simulator_.reset(new KingraySimulator(config));
+        simulator_->Start();
+
+        DeviceNetworkInfo info;
+        info.deviceType = DeviceType::PAT71;
+        info.deviceVendor = DeviceVendor::KINGRAY;
+        info.unicastIp = config.bindIp_;
+        info.unicastPort = simulator_->GetUdpPort();
+        controller_ = std::make_shared<KingrayController>(info);
+        controller_->Init();
+    }
+    ~SimulatorFixture()
+    {
+        controller_.reset();
+        simulator_->Stop();
+    }
+
+    std::unique_ptr<KingraySimulator> simulator_;
+    std::shared_ptr<KingrayController> controller_;
+};
+
+}  // namespace
+
+TEST_CASE("Device names are decoded from simulator replies", "[KingrayController]") {
+    SimulatorFixture fixture;
+    // 请求的设备ID为 0，模拟器应答 "MIC-0"
+    REQUIRE(fixture.controller_->GetDeviceName("0") == "MIC-0");
+
+    std::promise<std::string> name;
+    fixture.controller_->AsyncGetDeviceName("0", [&name](const std::string& result) { name.set_value(result); });
+    auto future = name.get_future();
+    REQUIRE(future.wait_for(std::chrono::seconds(2)) == std::future_status::ready);
+    REQUIRE(future.get() == "MIC-0");
+}
+
+TEST_CASE("Whole frames are not decoded as bodies", "[KingrayController]") {
+    const auto frame = MakeKingrayFrame(static_cast<uint16_t>(FunctionCode::PL_FUN_SINGLE_DEVICE_NAME_GET), 0,
+                                        {0x2D43494D, 0x00000031, 0, 0, 0, 0});
+    SingleDeviceNameGetResponseMsg msg;
+    REQUIRE(msg.Deserialize(Binary::Unpack(frame.data(), frame.size())));
+    REQUIRE(msg.name_ == "MIC-1");
+
+    // 消息头的帧头魔数被当作 dataLen 时不得越界读取
+    SingleDeviceNameGetResponseMsg body;
+    REQUIRE_THROWS(body.DeserializeBody(Binary::Unpack(frame.data(), frame.size())));
+
+    // 声明的 dataLen 超出帧长
+    auto truncated = frame;
+    truncated[MESSAGE_HEADER_SIZE + 3] = 0x40;
+    REQUIRE_FALSE(msg.Deserialize(Binary::Unpack(truncated.data(), truncated.size())));
+}
@@ -0,0 +1,155 @@
+#include <catch2/catch.hpp>
+#include <cstring>
+#include <random>
+#include "common/WordSum.h"
+#include "devices/KingrayControlMessage.h"
+#include "TestUtils.h"
+
+using TestUtils::MakeKingrayFrame;
+
+namespace
+{
+
+// 消息头之后的 dataLen | 消息体 | 校验和
+std::vector<uint8_t> BodyOf(const std::vector<uint8_t>& frame)
+{
+    return std::vector<uint8_t>(frame.begin() + MESSAGE_HEADER_SIZE, frame.end());
+}
+
+}  // namespace
+
+TEST_CASE("Layout bodies round-trip through PackBody and UnpackBody", "[KingrayLayout]") {
+    STATIC_REQUIRE(KingrayLayout::BODY_SIZE<NetworkInfo> == 20);
+
+    NetworkInfo in;
+    const uint8_t mac[6] = {1, 2, 3, 4, 5, 6};
+    memcpy(in.mac_, mac, sizeof(mac));
+    in.ip_[0] = 192;
+    in.ip_[3] = 10;
+    in.dhcpMode_ = 1;
+
+    Binary::Pack pack;
+    KingrayLayout::PackBody(pack, in);
+    REQUIRE(pack.size() == sizeof(uint32_t) + 20 + sizeof(uint32_t));
+
+    NetworkInfo out;
+    Binary::Unpack unpack(pack.data(), pack.size());
+    KingrayLayout::UnpackBody(unpack, out);
+    REQUIRE(unpack.empty());
+    REQUIRE(memcmp(out.mac_, mac, sizeof(mac)) == 0);
+    REQUIRE(out.ip_[0] == 192);
+    REQUIRE(out.ip_[3] == 10);
+    REQUIRE(out.dhcpMode_ == 1);
+}
+
+TEST_CASE("PackBody matches the hand-written wire format", "[KingrayLayout]") {
+    DeviceTypeBaseInfo info;
+    info.deviceType_ = 3;
+    Binary::Pack pack;
+    KingrayLayout::PackBody(pack, info);
+
+    const auto expected = BodyOf(MakeKingrayFrame(0, 0, {3}));
+    REQUIRE(std::vector<uint8_t>(pack.data(), pack.data() + pack.size()) == expected);
+}
+
+TEST_CASE("BodyView rejects truncated bodies and bad checksums", "[KingrayLayout]") {
+    auto body = BodyOf(MakeKingrayFrame(0, 0, {1, 2, 3}));
+    REQUIRE(KingrayLayout::BodyView(body.data(), body.size()).Valid());
+    REQUIRE(KingrayLayout::BodyView(body.data(), body.size()).size() == 12);
+
+    REQUIRE_FALSE(KingrayLayout::BodyView(body.data(), 3).Valid());
+    REQUIRE_FALSE(KingrayLayout::BodyView(body.data(), body.size() - 1).Valid());
+
+    // dataLen * 4 超出 32 位范围时同样按长度不足拒绝
+    auto oversized = body;
+    oversized[3] = 0x40;
+    REQUIRE_FALSE(KingrayLayout::BodyView(oversized.data(), oversized.size()).Valid());
+    oversized[0] = oversized[1] = oversized[2] = oversized[3] = 0xFF;
+    REQUIRE_FALSE(KingrayLayout::BodyView(oversized.data(), oversized.size()).Valid());
+
+    body[4] ^= 0x01;
+    REQUIRE_FALSE(KingrayLayout::BodyView(body.data(), body.size()).Valid());
+    Binary::Unpack unpack(body.data(), body.size());
+    REQUIRE_THROWS(KingrayLayout::BodyView(unpack));
+}
+
+TEST_CASE("BodyView reads stay inside the body", "[KingrayLayout]") {
+    const auto body = BodyOf(MakeKingrayFrame(0, 0, {0x04030201}));
+    const KingrayLayout::BodyView view(body.data(), body.size());
+    uint16_t value = 0;
+    view.Read(2, value);
+    REQUIRE(value == 0x0403);
+    REQUIRE_THROWS(view.Read(3, value));
+    uint32_t word = 0;
+    REQUIRE_THROWS(view.Read(1, word));
+}
+
+TEST_CASE("Record ranges decode device lists in place", "[KingrayLayout]") {
+    // deviceType | reserve | {deviceCode, idType} x 2 | 补齐
+    const auto frame = MakeKingrayFrame(static_cast<uint16_t>(FunctionCode::PL_FUN_ALL_MIC_ID_TYPE_GET), 1,
+                                        {0x00070005, 0x00020001, 0x00000008});
+    const KingrayFrameView view(frame.data(), frame.size());
+    REQUIRE(view.Valid());
+    const auto records = MicIdTypeGetResponseMsg::GetIdTypeInfos(view.Body());
+    REQUIRE(records.size() == 2);
+    REQUIRE(records[0].deviceCode_ == 7);
+    REQUIRE(records[0].idType_ == 1);
+    REQUIRE(records[1].deviceCode_ == 2);
+    REQUIRE(records[1].idType_ == 8);
+
+    MicIdTypeGetResponseMsg msg;
+    REQUIRE(msg.Deserialize(Binary::Unpack(frame.data(), frame.size())));
+    REQUIRE(msg.deviceType_ == 5);
+    REQUIRE(msg.idTypeInfoVec_.size() == 2);
+}
+
+TEST_CASE("SIMD word-sum kernels agree with the scalar kernel", "[KingrayLayout]") {
+    std::mt19937 random(42);
+    std::vector<uint8_t> data(4 * 1100 + 3);
+    for (auto& byte : data)
+    {
+        byte = static_cast<uint8_t>(random());
+    }
+
+    const size_t sizes[] = {0, 1, 7, 8, 9, 15, 16, 17, 31, 33, 64, 257, 1000};
+    for (const size_t words : sizes)
+    {
+        // 起始位置不要求对齐
+        for (size_t offset = 0; offset < 4; ++offset)
+        {
+            const uint8_t* begin = data.data() + offset;
+            const uint32_t expected = Binary::SumWordsScalar(begin, words);
+            REQUIRE(Binary::SumWords(begin, words) == expected);
+            REQUIRE(Binary::SelectSumWords()(begin, words) == expected);
+#if defined(BINARY_WORD_SUM_X86)
+            REQUIRE(Binary::SumWordsSse2(begin, words) == expected);
+#endif
+        }
+    }
+}
+
+TEST_CASE("The function code table resolves names", "[KingrayLayout]") {
+    const uint16_t netInfo = static_cast<uint16_t>(FunctionCode::PL_FUN_NETINFO_GET);
+    REQUIRE(std::string(GetFunctionCodeName(netInfo)) == "PL_FUN_NETINFO_GET");
+    REQUIRE(std::string(GetFunctionCodeName(static_cast<uint16_t>(FunctionCode::PL_FUN_SINGLE_DEVICE_NAME_GET))) ==
+            "PL_FUN_SINGLE_DEVICE_NAME_GET");
+    REQUIRE(std::string(GetFunctionCodeName(0xFFFF)) == "unknowCode");
+    REQUIRE(GetFunctionCodeInfo(static_cast<uint16_t>(FunctionCode::PL_FUN_UNKNOW)) == nullptr);
+    REQUIRE(GetFunctionCodeInfo(netInfo) == &FUNCTION_CODE_TABLE[netInfo]);
+}
+
+TEST_CASE("FrameHeaderView reads the header without copying", "[KingrayLayout]") {
+    const auto frame = MakeKingrayFrame(0x00C0, 7, {});
+    const FrameHeaderView header(frame.data(), frame.size());
+    REQUIRE(header.Valid());
+    REQUIRE(header.GetFunctionCode() == 0x00C0);
+    REQUIRE(header.GetDeviceID() == 7);
+    REQUIRE(header.GetProductID() == 0x02020483);
+    REQUIRE_FALSE(FrameHeaderView(frame.data(), MESSAGE_HEADER_SIZE - 1).Valid());
+
+    uint16_t functionCode = 0;
+    uint32_t sequence = 0;
+    REQUIRE(GetCorrelationKeyByData(frame.data(), frame.size(), functionCode, sequence));
+    REQUIRE(functionCode == 0x00C0);
+    REQUIRE(sequence == 7);
+}
@@ -0,0 +1,272 @@
+#include <catch2/catch.hpp>
+#include <atomic>
+#include <future>
+#include <mutex>
+#include "RequestEngine.h"
+#include "TestUtils.h"
+
+using namespace aoip;
+using TestUtils::ToFrameBuffer;
+using TestUtils::WaitFor;
+
+namespace
+{
+
+// 测试帧格式：功能号(u16) | 序列号(u32) | 数据
+std::vector<uint8_t> MakeFrame(uint16_t functionCode, uint32_t sequence, uint8_t value = 0)
+{
+    std::vector<uint8_t> frame(sizeof(functionCode) + sizeof(sequence) + 1);
+    memcpy(frame.data(), &functionCode, sizeof(functionCode));
+    memcpy(frame.data() + sizeof(functionCode), &sequence, sizeof(sequence));
+    frame.back() = value;
+    return frame;
+}
+
+class FakeTransport : public Transport
+{
+public:
+    bool Transmit(const FrameBuffer& frame) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        frames_.push_back(frame.ToVector());
+        return true;
+    }
+    void Sync() override {}
+
+    size_t Count()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return frames_.size();
+    }
+
+private:
+    std::mutex mutex_;
+    std::vector<std::vector<uint8_t>> frames_;
+};
+
+class FrameCallback : public UdpCallback
+{
+public:
+    bool GetFunctionCode(const FrameBuffer& response, uint16_t& functionCode) const override
+    {
+        uint32_t sequence = 0;
+        return GetCorrelationKey(response, functionCode, sequence);
+    }
+    bool GetCorrelationKey(const FrameBuffer& response, uint16_t& functionCode, uint32_t& sequence) const override
+    {
+        if (response.size() < sizeof(functionCode) + sizeof(sequence))
+        {
+            return false;
+        }
+        memcpy(&functionCode, response.data(), sizeof(functionCode));
+        memcpy(&sequence, response.data() + sizeof(functionCode), sizeof(sequence));
+        return true;
+    }
+};
+
+struct EngineFixture
+{
+    explicit EngineFixture(const RequestConfig& config = RequestConfig(), std::shared_ptr<EndpointPacer> pacer = nullptr)
+        : reactor_(std::make_shared<Reactor>()),
+          callback_(std::make_shared<FrameCallback>()),
+          engine_(reactor_, config, transport_, Endpoint(), pacer)
+    {
+        reactor_->Start();
+        engine_.SetCorrelationCallback(callback_);
+        engine_.Start();
+    }
+    ~EngineFixture()
+    {
+        engine_.Stop("test finished");
+        reactor_->Stop();
+    }
+
+    void Respond(uint16_t functionCode, uint32_t sequence, uint8_t value = 0)
+    {
+        const auto frame = MakeFrame(functionCode, sequence, value);
+        engine_.OnReceive(ToFrameBuffer(frame.data(), frame.size()));
+    }
+
+    std::shared_ptr<Reactor> reactor_;
+    FakeTransport transport_;
+    std::shared_ptr<FrameCallback> callback_;
+    RequestEngine engine_;
+};
+
+RequestConfig NoPacing(uint32_t timeoutMs, uint32_t maxRetries)
+{
+    RequestConfig config;
+    config.timeoutMs_ = timeoutMs;
+    config.minTimeoutMs_ = 5;
+    config.maxRetries_ = maxRetries;
+    config.pacer_ = PacerConfig{0, 0, 0};
+    return config;
+}
+
+bool IsReady(const std::future<FrameBuffer>& future)
+{
+    return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+}  // namespace
+
+TEST_CASE("Keyed requests are correlated by function code and sequence", "[RequestEngine]") {
+    EngineFixture fixture(NoPacing(1000, 0));
+    const auto request = MakeFrame(0x10, 0);
+    auto first = fixture.engine_.SendRequest(0x10, 1, request.data(), request.size());
+    auto second = fixture.engine_.SendRequest(0x10, 2, request.data(), request.size());
+    REQUIRE(fixture.transport_.Count() == 2);
+
+    // 响应乱序到达，各自匹配到对应序列号的请求
+    fixture.Respond(0x10, 2, 0xB2);
+    REQUIRE(IsReady(second));
+    REQUIRE_FALSE(IsReady(first));
+    fixture.Respond(0x10, 1, 0xB1);
+    REQUIRE(first.get().data()[6] == 0xB1);
+    REQUIRE(second.get().data()[6] == 0xB2);
+}
+
+TEST_CASE("Unkeyed requests are matched by function code only", "[RequestEngine]") {
+    EngineFixture fixture(NoPacing(1000, 0));
+    const auto request = MakeFrame(0x20, 0);
+    auto future = fixture.engine_.SendRequest(0x20, request.data(), request.size());
+
+    fixture.Respond(0x21, 7);
+    REQUIRE_FALSE(IsReady(future));
+    fixture.Respond(0x20, 7, 0x55);
+    REQUIRE(future.get().data()[6] == 0x55);
+}
+
+TEST_CASE("Identical in-flight requests are coalesced into one transmission", "[RequestEngine]") {
+    EngineFixture fixture(NoPacing(1000, 0));
+    const auto request = MakeFrame(0x30, 0, 1);
+    auto first = fixture.engine_.SendRequest(0x30, 9, request.data(), request.size());
+    auto second = fixture.engine_.SendRequest(0x30, 9, request.data(), request.size());
+    REQUIRE(fixture.transport_.Count() == 1);
+
+    fixture.Respond(0x30, 9, 0x77);
+    REQUIRE(first.get().data()[6] == 0x77);
+    REQUIRE(second.get().data()[6] == 0x77);
+}
+
+TEST_CASE("A conflicting request fails alone without throwing", "[RequestEngine]") {
+    EngineFixture fixture(NoPacing(1000, 0));
+    const auto request = MakeFrame(0x31, 0, 1);
+    const auto conflicting = MakeFrame(0x31, 0, 2);
+    auto first = fixture.engine_.SendRequest(0x31, 9, request.data(), request.size());
+
+    // 同一键而报文不同：只结束该请求，已登记的请求不受影响
+    auto second = fixture.engine_.MakeRequest(0x31, 9, RequestPriority::NORMAL);
+    auto secondFuture = second->promise_.get_future();
+    bool registered = true;
+    REQUIRE_NOTHROW(registered = fixture.engine_.Register(second, conflicting.data(), conflicting.size()));
+    REQUIRE_FALSE(registered);
+    REQUIRE_THROWS_WITH(secondFuture.get(), "Duplicate in-flight request");
+
+    std::promise<bool> failed;
+    fixture.engine_.SendRequest(0x31, 9, conflicting.data(), conflicting.size(),
+                                [&failed](const FrameBuffer& /*response*/, std::exception_ptr error) {
+                                    failed.set_value(error != nullptr);
+                                });
+    REQUIRE(failed.get_future().get());
+    REQUIRE(fixture.transport_.Count() == 1);
+
+    fixture.Respond(0x31, 9, 0x88);
+    REQUIRE(first.get().data()[6] == 0x88);
+}
+
+TEST_CASE("Unanswered requests are retransmitted and then time out", "[RequestEngine]") {
+    EngineFixture fixture(NoPacing(20, 2));
+    const auto request = MakeFrame(0x40, 0);
+    auto future = fixture.engine_.SendRequest(0x40, 1, request.data(), request.size());
+
+    REQUIRE(future.wait_for(std::chrono::seconds(2)) == std::future_status::ready);
+    REQUIRE_THROWS_WITH(future.get(), "Request timeout");
+    // 首次发送加 maxRetries_ 次重传
+    REQUIRE(fixture.transport_.Count() == 3);
+}
+
+TEST_CASE("A response after a retransmission completes the request", "[RequestEngine]") {
+    EngineFixture fixture(NoPacing(20, 10));
+    const auto request = MakeFrame(0x41, 0);
+    auto future = fixture.engine_.SendRequest(0x41, 1, request.data(), request.size());
+
+    REQUIRE(WaitFor([&fixture]() { return fixture.transport_.Count() >= 2; }));
+    fixture.Respond(0x41, 1, 0x66);
+    REQUIRE(future.get().data()[6] == 0x66);
+}
+
+TEST_CASE("Completion callbacks receive the response or the error", "[RequestEngine]") {
+    EngineFixture fixture(NoPacing(20, 0));
+    const auto request = MakeFrame(0x50, 0);
+    std::promise<uint8_t> answered;
+    fixture.engine_.SendRequest(0x50, 1, request.data(), request.size(),
+                                [&answered](const FrameBuffer& response, std::exception_ptr error) {
+                                    answered.set_value(error ? 0 : response.data()[6]);
+                                });
+    std::promise<bool> failed;
+    fixture.engine_.SendRequest(0x50, 2, request.data(), request.size(),
+                                [&failed](const FrameBuffer& response, std::exception_ptr error) {
+                                    failed.set_value(error != nullptr && response.empty());
+                                });
+
+    fixture.Respond(0x50, 1, 0x42);
+    REQUIRE(answered.get_future().get() == 0x42);
+    REQUIRE(failed.get_future().get());
+}
+
+TEST_CASE("Stop fails all in-flight requests", "[RequestEngine]") {
+    EngineFixture fixture(NoPacing(10000, 0));
+    const auto request = MakeFrame(0x60, 0);
+    auto future = fixture.engine_.SendRequest(0x60, 1, request.data(), request.size());
+    fixture.engine_.Stop("stopped");
+    REQUIRE_THROWS_WITH(future.get(), "stopped");
+}
+
+TEST_CASE("Requests racing with Stop are either refused or failed", "[RequestEngine]") {
+    EngineFixture fixture(NoPacing(10000, 0));
+    const auto request = MakeFrame(0x61, 0);
+    const uint32_t count = 2000;
+    std::atomic<uint32_t> finished{0};
+    std::atomic<uint32_t> refused{0};
+    std::thread sender([&]() {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            try
+            {
+                fixture.engine_.SendRequest(0x61, i, request.data(), request.size(),
+                                            [&finished](const FrameBuffer&, std::exception_ptr) { ++finished; });
+            }
+            catch (const std::exception&)
+            {
+                ++refused;
+            }
+        }
+    });
+    REQUIRE(TestUtils::WaitFor([&fixture]() { return fixture.transport_.Count() > 0; }));
+    fixture.engine_.Stop("stopped");
+    sender.join();
+    // Stop 之后登记的请求不会留在引擎中等待超时
+    REQUIRE(finished + refused == count);
+}
+
+TEST_CASE("Unmatched frames are delivered to matching subscriptions", "[RequestEngine]") {
+    EngineFixture fixture(NoPacing(1000, 0));
+    auto all = fixture.engine_.Subscribe();
+    auto filtered = fixture.engine_.Subscribe(0x70, 3);
+
+    fixture.Respond(0x70, 3);
+    fixture.Respond(0x70, 4);
+
+    EventFrame event;
+    REQUIRE(filtered->Poll(event));
+    REQUIRE(event.sequence_ == 3);
+    REQUIRE_FALSE(filtered->Poll(event));
+    REQUIRE(all->Poll(event));
+    REQUIRE(all->Poll(event));
+    REQUIRE(event.sequence_ == 4);
+
+    fixture.engine_.Unsubscribe(all);
+    fixture.Respond(0x70, 5);
+    REQUIRE_FALSE(all->Poll(event));
+}
@@ -0,0 +1,69 @@
+#include <catch2/catch.hpp>
+#include "common/Packet.h"
+
+TEST_CASE("Small packs stay in the inline buffer", "[Serializer]") {
+    Binary::Pack pack;
+    pack << static_cast<uint32_t>(0x5A1AA1A5) << static_cast<uint16_t>(0x0102);
+    REQUIRE(pack.size() == 6);
+    REQUIRE(pack.capacity() == Binary::Serializer::INLINE_CAPACITY);
+
+    Binary::Unpack unpack(pack.data(), pack.size());
+    uint32_t magic = 0;
+    unpack >> magic;
+    REQUIRE(magic == 0x5A1AA1A5);
+    REQUIRE(unpack.pop_uint16() == 0x0102);
+    REQUIRE_NOTHROW(unpack.finish());
+}
+
+TEST_CASE("Writes append after reserve and growth keeps the data", "[Serializer]") {
+    Binary::Pack pack;
+    pack << static_cast<uint32_t>(1);
+    pack.reserve(Binary::Serializer::INLINE_CAPACITY + 100);
+    REQUIRE(pack.capacity() >= Binary::Serializer::INLINE_CAPACITY + 100);
+    REQUIRE(pack.size() == 4);
+
+    for (uint32_t i = 2; i <= 300; ++i)
+    {
+        pack << i;
+    }
+    REQUIRE(pack.size() == 300 * sizeof(uint32_t));
+    Binary::Unpack unpack(pack.data(), pack.size());
+    for (uint32_t i = 1; i <= 300; ++i)
+    {
+        REQUIRE(unpack.pop_uint32() == i);
+    }
+}
+
+TEST_CASE("Writes beyond the buffer limit throw", "[Serializer]") {
+    Binary::Pack pack;
+    const std::vector<char> block(Binary::MaxBufferSize(), 0);
+    pack.push(block.data(), block.size());
+    REQUIRE(pack.size() == Binary::MaxBufferSize());
+    REQUIRE_THROWS(pack.push_uint8(1));
+    REQUIRE_THROWS(pack.reserve(Binary::MaxBufferSize() + 1));
+}
+
+TEST_CASE("Clear keeps the buffer and restarts the word sum", "[Serializer]") {
+    Binary::Pack pack;
+    pack << static_cast<uint32_t>(0xFFFFFFFF);
+    pack.begin_word_sum();
+    pack << static_cast<uint32_t>(2) << static_cast<uint32_t>(3);
+    REQUIRE(pack.word_sum() == 5);
+    // 末尾不足一字的字节按补 0 累加
+    pack << static_cast<uint8_t>(1);
+    REQUIRE(pack.word_sum() == 6);
+
+    pack.clear();
+    REQUIRE(pack.size() == 0);
+    pack.begin_word_sum();
+    pack << static_cast<uint32_t>(7);
+    REQUIRE(pack.word_sum() == 7);
+}
+
+TEST_CASE("Reading past the end throws", "[Serializer]") {
+    const uint8_t data[3] = {1, 2, 3};
+    Binary::Unpack unpack(data, sizeof(data));
+    REQUIRE_THROWS(unpack.pop_uint32());
+    REQUIRE(unpack.pop_uint16() == 0x0201);
+    REQUIRE_THROWS(unpack.skip(2));
+}
@@ -0,0 +1,64 @@
+#include <catch2/catch.hpp>
+#include <thread>
+#include "SpscQueue.h"
+
+using namespace aoip;
+
+TEST_CASE("Capacity is rounded up to a power of two", "[SpscQueue]") {
+    SpscQueue<int> queue(5);
+    REQUIRE(queue.Capacity() == 8);
+    for (int i = 0; i < 8; ++i)
+    {
+        REQUIRE(queue.TryPush(i));
+    }
+    REQUIRE_FALSE(queue.TryPush(8));
+    REQUIRE(queue.Size() == 8);
+
+    int value = -1;
+    for (int i = 0; i < 8; ++i)
+    {
+        REQUIRE(queue.TryPop(value));
+        REQUIRE(value == i);
+    }
+    REQUIRE_FALSE(queue.TryPop(value));
+}
+
+TEST_CASE("Popped slots release the element", "[SpscQueue]") {
+    SpscQueue<std::shared_ptr<int>> queue(2);
+    auto element = std::make_shared<int>(1);
+    REQUIRE(queue.TryPush(element));
+    std::shared_ptr<int> popped;
+    REQUIRE(queue.TryPop(popped));
+    popped.reset();
+    REQUIRE(element.use_count() == 1);
+}
+
+TEST_CASE("A producer and a consumer thread see every element in order", "[SpscQueue]") {
+    constexpr uint32_t COUNT = 200000;
+    SpscQueue<uint32_t> queue(64);
+    std::thread producer([&queue]() {
+        for (uint32_t i = 0; i < COUNT; ++i)
+        {
+            while (!queue.TryPush(i))
+            {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    uint32_t expected = 0;
+    bool ordered = true;
+    while (expected < COUNT)
+    {
+        uint32_t value = 0;
+        if (!queue.TryPop(value))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        ordered = ordered && value == expected;
+        ++expected;
+    }
+    producer.join();
+    REQUIRE(ordered);
+}
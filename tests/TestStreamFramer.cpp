@@ -0,0 +1,87 @@
+#include <catch2/catch.hpp>
+#include "StreamFramer.h"
+#include "TestUtils.h"
+
+using namespace aoip;
+using TestUtils::MakeKingrayFrame;
+
+namespace
+{
+
+struct Collector
+{
+    std::vector<std::vector<uint8_t>> frames_;
+    StreamFramer::FrameHandler Handler()
+    {
+        return [this](const FrameBuffer& frame) { frames_.push_back(frame.ToVector()); };
+    }
+};
+
+}  // namespace
+
+TEST_CASE("Frames split across reads are reassembled", "[StreamFramer]") {
+    StreamFramer framer;
+    Collector collector;
+    auto stream = MakeKingrayFrame(0x00C0, 1, {1, 2, 3});
+    const auto second = MakeKingrayFrame(0x00C1, 2, {});
+    stream.insert(stream.end(), second.begin(), second.end());
+
+    for (const auto byte : stream)
+    {
+        framer.Feed(&byte, 1, collector.Handler());
+    }
+    REQUIRE(collector.frames_.size() == 2);
+    REQUIRE(collector.frames_[0] == MakeKingrayFrame(0x00C0, 1, {1, 2, 3}));
+    REQUIRE(collector.frames_[1] == second);
+    REQUIRE(framer.GetPending() == 0);
+    REQUIRE(framer.GetDiscarded() == 0);
+}
+
+TEST_CASE("Garbage before a frame header is discarded", "[StreamFramer]") {
+    StreamFramer framer;
+    Collector collector;
+    std::vector<uint8_t> stream = {0x01, 0xA5, 0xA1, 0x02, 0x03};
+    const auto frame = MakeKingrayFrame(0x00C0, 1, {7});
+    stream.insert(stream.end(), frame.begin(), frame.end());
+
+    framer.Feed(stream.data(), stream.size(), collector.Handler());
+    REQUIRE(collector.frames_.size() == 1);
+    REQUIRE(collector.frames_[0] == frame);
+    REQUIRE(framer.GetDiscarded() == 5);
+}
+
+TEST_CASE("A header with an implausible length is skipped", "[StreamFramer]") {
+    StreamFramer framer;
+    Collector collector;
+    // 魔数出现在垃圾数据中，其后的长度字段超出帧上限
+    auto stream = MakeKingrayFrame(0x00C0, 1, {});
+    stream[12] = 0xFF;
+    stream[13] = 0xFF;
+    stream[14] = 0xFF;
+    const auto frame = MakeKingrayFrame(0x00C0, 2, {9, 9});
+    stream.insert(stream.end(), frame.begin(), frame.end());
+
+    framer.Feed(stream.data(), stream.size(), collector.Handler());
+    REQUIRE(collector.frames_.size() == 1);
+    REQUIRE(collector.frames_[0] == frame);
+    REQUIRE(framer.GetDiscarded() == stream.size() - frame.size());
+}
+
+TEST_CASE("Reset drops a partial frame", "[StreamFramer]") {
+    StreamFramer framer;
+    Collector collector;
+    const auto frame = MakeKingrayFrame(0x00C0, 1, {1, 2});
+    framer.Feed(frame.data(), frame.size() - 3, collector.Handler());
+    REQUIRE(framer.GetPending() == frame.size() - 3);
+
+    framer.Reset();
+    REQUIRE(framer.GetPending() == 0);
+    framer.Feed(frame.data(), frame.size(), collector.Handler());
+    REQUIRE(collector.frames_.size() == 1);
+}
+
+TEST_CASE("Invalid framer configurations are rejected", "[StreamFramer]") {
+    FramerConfig config;
+    config.maxFrameSize_ = 8;
+    REQUIRE_THROWS(StreamFramer(config));
+}
@@ -0,0 +1,94 @@
+#include <catch2/catch.hpp>
+#include "TimerWheel.h"
+
+using namespace aoip;
+
+namespace
+{
+
+using Clock = TimerWheel::Clock;
+
+Clock::time_point At(Clock::time_point start, uint32_t ms)
+{
+    return start + std::chrono::milliseconds(ms);
+}
+
+// 推进到 now 并执行到期回调，返回执行个数
+size_t AdvanceAndRun(TimerWheel& wheel, Clock::time_point now)
+{
+    std::vector<TimerWheel::TimerCallback> expired;
+    wheel.Advance(now, expired);
+    for (auto& cb : expired)
+    {
+        cb();
+    }
+    return expired.size();
+}
+
+}  // namespace
+
+TEST_CASE("Timers fire at their expiry tick and not before", "[TimerWheel]") {
+    const auto start = Clock::now();
+    TimerWheel wheel(start);
+    bool fired = false;
+    wheel.Schedule(start, 5, [&fired]() { fired = true; });
+
+    REQUIRE(AdvanceAndRun(wheel, At(start, 4)) == 0);
+    REQUIRE_FALSE(fired);
+    REQUIRE(AdvanceAndRun(wheel, At(start, 5)) == 1);
+    REQUIRE(fired);
+    REQUIRE(wheel.Size() == 0);
+}
+
+TEST_CASE("Timers on higher levels cascade down and fire on time", "[TimerWheel]") {
+    const auto start = Clock::now();
+    TimerWheel wheel(start);
+    // 分别落在第 1、2、3 层
+    const uint32_t delays[] = {70, 5000, 300000};
+    for (const auto delay : delays)
+    {
+        int fired = 0;
+        const auto now = At(start, delay);
+        wheel.Schedule(now - std::chrono::milliseconds(delay), delay, [&fired]() { ++fired; });
+        REQUIRE(AdvanceAndRun(wheel, now - std::chrono::milliseconds(1)) == 0);
+        REQUIRE(AdvanceAndRun(wheel, now) == 1);
+        REQUIRE(fired == 1);
+    }
+}
+
+TEST_CASE("Timers scheduled across several wheel turns keep their order", "[TimerWheel]") {
+    const auto start = Clock::now();
+    TimerWheel wheel(start);
+    std::vector<uint32_t> order;
+    for (const uint32_t delay : {4100u, 63u, 64u, 65u, 4095u, 4096u})
+    {
+        wheel.Schedule(start, delay, [&order, delay]() { order.push_back(delay); });
+    }
+    for (uint32_t ms = 0; ms <= 4100; ++ms)
+    {
+        AdvanceAndRun(wheel, At(start, ms));
+    }
+    REQUIRE(order == std::vector<uint32_t>{63, 64, 65, 4095, 4096, 4100});
+}
+
+TEST_CASE("Cancelled timers never fire", "[TimerWheel]") {
+    const auto start = Clock::now();
+    TimerWheel wheel(start);
+    bool fired = false;
+    const auto timerId = wheel.Schedule(start, 100, [&fired]() { fired = true; });
+    REQUIRE(wheel.Cancel(timerId));
+    REQUIRE_FALSE(wheel.Cancel(timerId));
+    AdvanceAndRun(wheel, At(start, 200));
+    REQUIRE_FALSE(fired);
+}
+
+TEST_CASE("NextTimeoutMs reports the wait until the next timer", "[TimerWheel]") {
+    const auto start = Clock::now();
+    TimerWheel wheel(start);
+    REQUIRE(wheel.NextTimeoutMs(start) == -1);
+
+    AdvanceAndRun(wheel, start);
+    wheel.Schedule(start, 10, []() {});
+    REQUIRE(wheel.NextTimeoutMs(start) == 10);
+    REQUIRE(wheel.NextTimeoutMs(At(start, 20)) == 0);
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "BufferPool.h"
+
+namespace TestUtils
+{
+
+// 按 Kingray 帧格式构造一帧：帧头 | 产品ID | 设备ID | 功能号 | dataLen | 数据 | 校验和
+inline std::vector<uint8_t> MakeKingrayFrame(uint16_t functionCode, uint16_t deviceId, const std::vector<uint32_t>& words)
+{
+    std::vector<uint8_t> frame;
+    auto put = [&frame](uint64_t value, size_t size) {
+        for (size_t i = 0; i < size; ++i)
+        {
+            frame.push_back(static_cast<uint8_t>(value >> (8 * i)));
+        }
+    };
+    put(0x5A1AA1A5, 4);
+    put(0x02020483, 4);
+    put(deviceId, 2);
+    put(functionCode, 2);
+    uint32_t sum = static_cast<uint32_t>(words.size());
+    put(words.size(), 4);
+    for (const auto word : words)
+    {
+        put(word, 4);
+        sum += word;
+    }
+    put(~sum + 1, 4);
+    return frame;
+}
+
+inline aoip::FrameBuffer ToFrameBuffer(const void* data, size_t size)
+{
+    aoip::FrameBuffer frame = aoip::BufferPool::Instance().Acquire(size);
+    memcpy(frame.MutableData(), data, size);
+    return frame;
+}
+
+// 轮询等待条件成立，超时返回 false
+template <typename Predicate>
+bool WaitFor(Predicate predicate, uint32_t timeoutMs = 2000)
+{
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    while (!predicate())
+    {
+        if (std::chrono::steady_clock::now() > deadline)
+        {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+}  // namespace TestUtils
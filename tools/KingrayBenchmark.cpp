@@ -0,0 +1,288 @@
+// Kingray 控制通道压测：以 KingrayController 的关联方式驱动 AsyncProtocol，
+// 对本地模拟器（或 --target 指定的主机）发起获取设备名称请求，统计吞吐量和延迟分位数；
+// 之后经 KingrayController 完成获取设备名称的往返，覆盖消息编解码和控制器回调
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "AsyncProtocol.h"
+#include "KingraySimulator.h"
+#include "devices/KingrayController.h"
+
+namespace
+{
+
+struct BenchmarkOptions
+{
+    uint64_t requests_{100000};   // 请求总数
+    uint32_t concurrency_{64};    // 同时在途的请求数，不超过设备数时在途请求不会被合并
+    uint32_t window_{64};         // 节流窗口
+    uint32_t rate_{0};            // 节流速率，0 表示不限速
+    uint32_t timeoutMs_{1000};
+    uint32_t retries_{3};
+    uint64_t controllerRequests_{2000}; // 经 KingrayController 的往返次数，0 表示跳过
+    std::string target_;          // 外部主机 ip:port，为空时启动内置模拟器
+    SimulatorConfig simulator_;
+};
+
+// 与 KingrayController 相同：以 (功能号, 设备ID) 关联响应
+class BenchmarkCallback : public aoip::UdpCallback
+{
+public:
+    bool GetFunctionCode(const aoip::FrameBuffer& response, uint16_t& functionCode) const override
+    {
+        uint32_t sequence = 0;
+        return GetCorrelationKey(response, functionCode, sequence);
+    }
+
+    bool GetCorrelationKey(const aoip::FrameBuffer& response, uint16_t& functionCode, uint32_t& sequence) const override
+    {
+        return GetCorrelationKeyByData(response.data(), response.size(), functionCode, sequence);
+    }
+};
+
+class Benchmark
+{
+public:
+    // 完成时以是否成功调用 Completion，可在任意线程调用
+    using Completion = std::function<void(bool success)>;
+    using Sender = std::function<void(uint64_t index, Completion completion)>;
+
+    Benchmark(const Sender& sender, uint64_t requests, uint32_t concurrency)
+        : sender_(sender), requests_(requests), concurrency_(concurrency)
+    {
+        latenciesUs_.reserve(requests);
+    }
+
+    void Run()
+    {
+        const auto start = std::chrono::steady_clock::now();
+        const uint32_t concurrency = static_cast<uint32_t>(std::min<uint64_t>(concurrency_, requests_));
+        for (uint32_t i = 0; i < concurrency; ++i)
+        {
+            Issue();
+        }
+        done_.get_future().wait();
+        elapsed_ = std::chrono::steady_clock::now() - start;
+    }
+
+    void Report(const char* name) const
+    {
+        std::vector<uint32_t> sorted(latenciesUs_);
+        std::sort(sorted.begin(), sorted.end());
+        auto percentile = [&sorted](double p) -> double {
+            if (sorted.empty())
+            {
+                return 0.0;
+            }
+            const size_t rank = static_cast<size_t>(std::ceil(p * sorted.size()));
+            return sorted[std::min(sorted.size(), std::max<size_t>(rank, 1)) - 1] / 1000.0;
+        };
+
+        const double seconds = std::chrono::duration<double>(elapsed_).count();
+        printf("%s\n", name);
+        printf("requests   : %llu (ok %zu, failed %llu)\n", static_cast<unsigned long long>(requests_),
+               sorted.size(), static_cast<unsigned long long>(failed_.load()));
+        printf("elapsed    : %.3f s\n", seconds);
+        printf("throughput : %.0f req/s\n", seconds > 0 ? sorted.size() / seconds : 0.0);
+        printf("latency ms : p50 %.3f  p99 %.3f  p999 %.3f  max %.3f\n", percentile(0.50), percentile(0.99),
+               percentile(0.999), sorted.empty() ? 0.0 : sorted.back() / 1000.0);
+    }
+
+private:
+    void Issue()
+    {
+        const uint64_t index = issued_++;
+        if (index >= requests_)
+        {
+            return;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        sender_(index, [this, start](bool success) { OnComplete(start, success); });
+    }
+
+    void OnComplete(std::chrono::steady_clock::time_point start, bool success)
+    {
+        if (!success)
+        {
+            ++failed_;
+        }
+        else
+        {
+            const auto us =
+                std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+            std::lock_guard<std::mutex> lock(mutex_);
+            latenciesUs_.push_back(static_cast<uint32_t>(us.count()));
+        }
+
+        if (++completed_ == requests_)
+        {
+            done_.set_value();
+            return;
+        }
+        Issue();
+    }
+
+    Sender sender_;
+    uint64_t requests_ = 0;
+    uint32_t concurrency_ = 0;
+    std::atomic<uint64_t> issued_{0};
+    std::atomic<uint64_t> completed_{0};
+    std::atomic<uint64_t> failed_{0};
+    std::mutex mutex_;
+    std::vector<uint32_t> latenciesUs_;
+    std::promise<void> done_;
+    std::chrono::steady_clock::duration elapsed_{};
+};
+
+void PrintUsage(const char* name)
+{
+    printf("usage: %s [options]\n"
+           "  --requests N      total requests (default 100000)\n"
+           "  --concurrency N   requests in flight (default 64)\n"
+           "  --window N        pacer in-flight window (default 64)\n"
+           "  --rate N          pacer requests per second, 0 = unlimited (default 0)\n"
+           "  --timeout MS      request timeout (default 1000)\n"
+           "  --retries N       retransmissions before failing (default 3)\n"
+           "  --controller N    round trips through KingrayController, 0 = skip (default 2000)\n"
+           "  --devices N       simulated devices (default 500)\n"
+           "  --latency MS      simulator reply latency (default 2)\n"
+           "  --jitter MS       simulator latency jitter (default 1)\n"
+           "  --loss RATE       simulator loss rate 0..1 (default 0)\n"
+           "  --target IP:PORT  benchmark an external host instead of the built-in simulator\n",
+           name);
+}
+
+bool ParseOptions(int argc, char* argv[], BenchmarkOptions& options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string key = argv[i];
+        if (i + 1 >= argc)
+        {
+            return false;
+        }
+        const std::string value = argv[++i];
+        if (key == "--requests") options.requests_ = std::stoull(value);
+        else if (key == "--concurrency") options.concurrency_ = std::stoul(value);
+        else if (key == "--window") options.window_ = std::stoul(value);
+        else if (key == "--rate") options.rate_ = std::stoul(value);
+        else if (key == "--timeout") options.timeoutMs_ = std::stoul(value);
+        else if (key == "--retries") options.retries_ = std::stoul(value);
+        else if (key == "--controller") options.controllerRequests_ = std::stoull(value);
+        else if (key == "--devices") options.simulator_.deviceCount_ = std::stoul(value);
+        else if (key == "--latency") options.simulator_.latencyMs_ = std::stoul(value);
+        else if (key == "--jitter") options.simulator_.jitterMs_ = std::stoul(value);
+        else if (key == "--loss") options.simulator_.lossRate_ = std::stod(value);
+        else if (key == "--target") options.target_ = value;
+        else return false;
+    }
+    return options.simulator_.deviceCount_ > 0 && options.requests_ > 0;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    BenchmarkOptions options;
+    try
+    {
+        if (!ParseOptions(argc, argv, options))
+        {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+    catch (const std::exception& e)
+    {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    std::unique_ptr<KingraySimulator> simulator;
+    aoip::ProtocolConfig config;
+    config.slavePort_ = 0;
+    config.broadcast_ = false;
+    config.timeoutMs_ = options.timeoutMs_;
+    config.maxRetries_ = options.retries_;
+    config.pacer_.maxInFlight_ = options.window_;
+    config.pacer_.ratePerSecond_ = options.rate_;
+    config.productId_ = options.simulator_.productId_;
+    if (options.target_.empty())
+    {
+        options.simulator_.udpPort_ = 0;
+        simulator.reset(new KingraySimulator(options.simulator_));
+        simulator->Start();
+        config.masterIp_ = options.simulator_.bindIp_;
+        config.masterPort_ = simulator->GetUdpPort();
+    }
+    else
+    {
+        const auto colon = options.target_.find(':');
+        config.masterIp_ = options.target_.substr(0, colon);
+        config.masterPort_ = colon == std::string::npos ? 60000 : std::stoul(options.target_.substr(colon + 1));
+    }
+
+    auto callback = std::make_shared<BenchmarkCallback>();
+    aoip::AsyncProtocol protocol(config);
+    protocol.SetUdpCallback(callback);
+    protocol.Start();
+
+    printf("target     : %s:%u, %u devices\n", config.masterIp_.c_str(), config.masterPort_,
+           options.simulator_.deviceCount_);
+    // 轮询各设备，并发数不超过设备数时同一设备不会有多个相同的在途请求
+    Benchmark benchmark(
+        [&protocol, &options](uint64_t index, Benchmark::Completion completion) {
+            const uint16_t deviceId = static_cast<uint16_t>(index % options.simulator_.deviceCount_);
+            const uint16_t functionCode = static_cast<uint16_t>(FunctionCode::PL_FUN_SINGLE_DEVICE_NAME_GET);
+            Binary::Pack pack;
+            pack << static_cast<uint32_t>(PROTOCOL_HEADER) << options.simulator_.productId_ << deviceId << functionCode;
+            protocol.SendRequest(functionCode, deviceId, pack.data(), pack.size(),
+                                 [completion](const aoip::FrameBuffer& /*response*/, std::exception_ptr error) {
+                                     completion(!error);
+                                 });
+        },
+        options.requests_, options.concurrency_);
+    benchmark.Run();
+    benchmark.Report("[AsyncProtocol]");
+
+    const auto pacer = protocol.GetPacerMetrics();
+    printf("pacer      : admitted %llu, throttled %llu\n", static_cast<unsigned long long>(pacer.admitted_),
+           static_cast<unsigned long long>(pacer.throttled_));
+    protocol.Stop();
+
+    if (options.controllerRequests_ > 0)
+    {
+        // 控制器的请求都发往同一设备，相同的在途请求会被合并，因此逐个往返
+        DeviceNetworkInfo info;
+        info.deviceVendor = DeviceVendor::KINGRAY;
+        info.unicastIp = config.masterIp_;
+        info.unicastPort = config.masterPort_;
+        auto controller = std::make_shared<KingrayController>(info);
+        controller->Init();
+        Benchmark roundTrip(
+            [&controller](uint64_t /*index*/, Benchmark::Completion completion) {
+                controller->AsyncGetDeviceName("0", [completion](const std::string& name) { completion(!name.empty()); });
+            },
+            options.controllerRequests_, 1);
+        roundTrip.Run();
+        roundTrip.Report("[KingrayController]");
+    }
+
+    if (simulator)
+    {
+        simulator->Stop();
+        const auto stats = simulator->GetStats();
+        printf("simulator  : received %llu, replied %llu, dropped %llu, ignored %llu\n",
+               static_cast<unsigned long long>(stats.received_), static_cast<unsigned long long>(stats.replied_),
+               static_cast<unsigned long long>(stats.dropped_), static_cast<unsigned long long>(stats.ignored_));
+    }
+    return 0;
+}
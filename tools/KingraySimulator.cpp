@@ -0,0 +1,329 @@
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include "KingraySimulator.h"
+#include "Logger.h"
+#include "code/ErrorCode.h"
+
+KingraySimulator::KingraySimulator(const SimulatorConfig& config)
+    : config_(config)
+    , reactor_(std::make_shared<aoip::Reactor>())
+    , random_(std::random_device()())
+{
+}
+
+KingraySimulator::~KingraySimulator()
+{
+    Stop();
+}
+
+void KingraySimulator::Start()
+{
+    if (running_.exchange(true))
+    {
+        return;
+    }
+
+    OpenUdp();
+    if (config_.serial_)
+    {
+        OpenSerial();
+    }
+    reactor_->Start();
+}
+
+void KingraySimulator::Stop()
+{
+    if (!running_.exchange(false))
+    {
+        return;
+    }
+
+    // 先停止事件循环，未到期的延迟应答随之丢弃
+    reactor_->Stop();
+    if (socket_)
+    {
+        reactor_->RemoveHandler(socket_->GetFd());
+        socket_.reset();
+    }
+    CloseSerial();
+}
+
+SimulatorStats KingraySimulator::GetStats() const
+{
+    SimulatorStats stats;
+    stats.received_ = received_.load();
+    stats.replied_ = replied_.load();
+    stats.dropped_ = dropped_.load();
+    stats.ignored_ = ignored_.load();
+    return stats;
+}
+
+void KingraySimulator::OpenUdp()
+{
+    aoip::UdpConfig udpConfig;
+    udpConfig.bindIp_ = config_.bindIp_;
+    udpConfig.bindPort_ = config_.udpPort_;
+    udpConfig.recvBufferSize_ = 4 * 1024 * 1024;
+    udpConfig.sendBufferSize_ = 4 * 1024 * 1024;
+    socket_.reset(new aoip::UdpSocket(udpConfig));
+
+    std::string ip;
+    if (!socket_->SetNonBlocking(true) || !socket_->GetLocalAddress(ip, udpPort_) ||
+        !reactor_->AddHandler(socket_->GetFd(), [this]() { OnUdpReadable(); }))
+    {
+        RUNTIME_EXCEPTION("Failed to open simulator udp port " << config_.udpPort_ << ": " << socket_->GetLastError());
+    }
+}
+
+void KingraySimulator::OpenSerial()
+{
+    serialFd_ = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (serialFd_ < 0 || grantpt(serialFd_) < 0 || unlockpt(serialFd_) < 0)
+    {
+        CloseSerial();
+        RUNTIME_EXCEPTION("Failed to open pty: " << strerror(errno));
+    }
+    serialPath_ = ptsname(serialFd_);
+
+    // 原始模式，不做行缓冲和字符转换
+    struct termios tio;
+    tcgetattr(serialFd_, &tio);
+    cfmakeraw(&tio);
+    tcsetattr(serialFd_, TCSANOW, &tio);
+
+    serialSlaveFd_ = open(serialPath_.c_str(), O_RDWR | O_NOCTTY);
+    if (serialSlaveFd_ < 0 || !reactor_->AddHandler(serialFd_, [this]() { OnSerialReadable(); }))
+    {
+        CloseSerial();
+        RUNTIME_EXCEPTION("Failed to open pty slave " << serialPath_ << ": " << strerror(errno));
+    }
+}
+
+void KingraySimulator::CloseSerial()
+{
+    if (serialFd_ >= 0)
+    {
+        reactor_->RemoveHandler(serialFd_);
+        close(serialFd_);
+        serialFd_ = -1;
+    }
+    if (serialSlaveFd_ >= 0)
+    {
+        close(serialSlaveFd_);
+        serialSlaveFd_ = -1;
+    }
+    serialBuffer_.clear();
+}
+
+void KingraySimulator::OnUdpReadable()
+{
+    uint8_t buffer[2048];
+    for (;;)
+    {
+        size_t len = sizeof(buffer);
+        aoip::Endpoint from;
+        if (!socket_->RecvFrom(buffer, len, from))
+        {
+            break;
+        }
+        HandleFrame(buffer, len, [this, from](const std::vector<uint8_t>& frame) {
+            socket_->SendTo(frame.data(), frame.size(), from);
+        });
+    }
+}
+
+void KingraySimulator::OnSerialReadable()
+{
+    uint8_t buffer[1024];
+    for (;;)
+    {
+        const ssize_t count = read(serialFd_, buffer, sizeof(buffer));
+        if (count <= 0)
+        {
+            break;
+        }
+        serialBuffer_.insert(serialBuffer_.end(), buffer, buffer + count);
+    }
+    ParseSerialStream();
+}
+
+void KingraySimulator::ParseSerialStream()
+{
+    const uint32_t magic = PROTOCOL_HEADER;
+    const uint8_t* magicBytes = reinterpret_cast<const uint8_t*>(&magic);
+    auto isMagic = [magic](const uint8_t* p) { return memcmp(p, &magic, sizeof(magic)) == 0; };
+
+    size_t offset = 0;
+    while (serialBuffer_.size() - offset >= HEADER_SIZE)
+    {
+        const uint8_t* frame = serialBuffer_.data() + offset;
+        const size_t available = serialBuffer_.size() - offset;
+        if (!isMagic(frame))
+        {
+            // 帧头错位，丢弃到下一个帧头，找不到时保留末尾可能是半个帧头的字节；
+            // 立即丢弃使帧总从缓冲区的 4 字节对齐处开始
+            auto next = std::search(serialBuffer_.begin() + offset + 1, serialBuffer_.end(), magicBytes,
+                                    magicBytes + sizeof(magic));
+            if (next == serialBuffer_.end())
+            {
+                next = serialBuffer_.end() - (sizeof(magic) - 1);
+            }
+            serialBuffer_.erase(serialBuffer_.begin(), next);
+            offset = 0;
+            continue;
+        }
+
+        // 紧跟消息头的是下一帧或已无数据时，视为不带消息体的请求（写端按整帧写入）
+        size_t frameLen = HEADER_SIZE;
+        if (available >= HEADER_SIZE + sizeof(uint32_t) && !isMagic(frame + HEADER_SIZE))
+        {
+            uint32_t dataLen = 0;
+            memcpy(&dataLen, frame + HEADER_SIZE, sizeof(dataLen));
+            if (dataLen <= MAX_BODY_WORDS)
+            {
+                frameLen = HEADER_SIZE + sizeof(uint32_t) * (dataLen + 2);
+                if (available < frameLen)
+                {
+                    break;
+                }
+            }
+        }
+
+        HandleFrame(frame, frameLen, [this](const std::vector<uint8_t>& reply) {
+            if (serialFd_ >= 0 && write(serialFd_, reply.data(), reply.size()) < 0)
+            {
+                AOIP_LOG_ERROR("serial write failed: " << strerror(errno));
+            }
+        });
+        offset += frameLen;
+    }
+    serialBuffer_.erase(serialBuffer_.begin(), serialBuffer_.begin() + std::min(offset, serialBuffer_.size()));
+}
+
+void KingraySimulator::HandleFrame(const uint8_t* data, size_t len, const Reply& reply)
+{
+    ++received_;
+    const FrameHeaderView view(data, len);
+    if (!view.Valid())
+    {
+        ++ignored_;
+        return;
+    }
+    const MessageHeader header = view.Header();
+
+    // 请求消息体：dataLen + 数据 + 校验和
+    const uint8_t* body = nullptr;
+    size_t bodyLen = 0;
+    if (len >= HEADER_SIZE + sizeof(uint32_t) * 2)
+    {
+        uint32_t dataLen = 0;
+        memcpy(&dataLen, data + HEADER_SIZE, sizeof(dataLen));
+        // 以字数比较，避免 dataLen + 2 回绕
+        if (dataLen <= (len - HEADER_SIZE) / sizeof(uint32_t) - 2)
+        {
+            body = data + HEADER_SIZE + sizeof(uint32_t);
+            bodyLen = dataLen * sizeof(uint32_t);
+        }
+    }
+
+    if (BROADCAST_DEVICE_ID == header.deviceID_)
+    {
+        for (uint32_t deviceId = 0; deviceId < config_.deviceCount_; ++deviceId)
+        {
+            ScheduleReply(MakeResponse(header, static_cast<uint16_t>(deviceId), body, bodyLen), reply);
+        }
+        return;
+    }
+
+    if (header.deviceID_ >= config_.deviceCount_)
+    {
+        ++ignored_;
+        return;
+    }
+    ScheduleReply(MakeResponse(header, header.deviceID_, body, bodyLen), reply);
+}
+
+std::vector<uint8_t> KingraySimulator::MakeResponse(const MessageHeader& header, uint16_t deviceId,
+                                                    const uint8_t* body, size_t bodyLen) const
+{
+    std::vector<uint32_t> words;
+    if (body)
+    {
+        words.resize((bodyLen + sizeof(uint32_t) - 1) / sizeof(uint32_t));
+        memcpy(words.data(), body, bodyLen);
+    }
+    else if (static_cast<uint16_t>(FunctionCode::PL_FUN_SINGLE_DEVICE_NAME_GET) == header.functionCode_)
+    {
+        // 设备名称固定 24 字节
+        words.resize(6);
+        snprintf(reinterpret_cast<char*>(words.data()), words.size() * sizeof(uint32_t), "MIC-%u", deviceId);
+    }
+    else
+    {
+        words.resize(DEFAULT_BODY_WORDS);
+    }
+
+    Binary::Pack pack;
+    const uint32_t dataLen = static_cast<uint32_t>(words.size());
+    pack << header.frameHeader_ << header.productID_ << deviceId << header.functionCode_;
+    // 校验和覆盖 dataLen 和消息体，在写入的同时累加
+    pack.begin_word_sum();
+    pack << dataLen;
+    for (const auto word : words)
+    {
+        pack << word;
+    }
+    pack << static_cast<uint32_t>(~pack.word_sum() + 1);
+    return std::vector<uint8_t>(pack.data(), pack.data() + pack.size());
+}
+
+void KingraySimulator::ScheduleReply(std::vector<uint8_t> frame, const Reply& reply)
+{
+    if (ShouldDrop())
+    {
+        ++dropped_;
+        return;
+    }
+
+    const uint32_t delayMs = NextDelayMs();
+    if (0 == delayMs)
+    {
+        reply(frame);
+        ++replied_;
+        return;
+    }
+    reactor_->RunAfter(delayMs, [this, frame = std::move(frame), reply]() {
+        reply(frame);
+        ++replied_;
+    });
+}
+
+uint32_t KingraySimulator::NextDelayMs()
+{
+    if (0 == config_.jitterMs_)
+    {
+        return config_.latencyMs_;
+    }
+
+    const int64_t low = static_cast<int64_t>(config_.latencyMs_) - config_.jitterMs_;
+    const int64_t high = static_cast<int64_t>(config_.latencyMs_) + config_.jitterMs_;
+    std::lock_guard<std::mutex> lock(randomMutex_);
+    const int64_t delay = std::uniform_int_distribution<int64_t>(low, high)(random_);
+    return static_cast<uint32_t>(std::max<int64_t>(delay, 0));
+}
+
+bool KingraySimulator::ShouldDrop()
+{
+    if (config_.lossRate_ <= 0.0)
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(randomMutex_);
+    return std::uniform_real_distribution<double>(0.0, 1.0)(random_) < config_.lossRate_;
+}
@@ -0,0 +1,96 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+#include "Reactor.h"
+#include "UdpSocket.h"
+#include "devices/KingrayControlMessage.h"
+
+// 模拟器配置
+struct SimulatorConfig
+{
+    std::string bindIp_{"127.0.0.1"};
+    uint16_t udpPort_{60000};        // 0 表示由系统分配，通过 GetUdpPort 获取
+    bool serial_{false};             // 是否同时打开 pty 串口
+    uint32_t deviceCount_{500};      // 模拟的设备数量，设备ID为 [0, deviceCount_)
+    uint32_t productId_{0x02020483};
+    uint32_t latencyMs_{2};          // 应答延迟
+    uint32_t jitterMs_{1};           // 应答延迟在 [latencyMs_ - jitterMs_, latencyMs_ + jitterMs_] 内均匀分布
+    double lossRate_{0.0};           // 请求丢弃概率 [0, 1]
+};
+
+// 模拟器统计
+struct SimulatorStats
+{
+    uint64_t received_{0};  // 收到的请求帧数
+    uint64_t replied_{0};   // 发出的应答帧数
+    uint64_t dropped_{0};   // 按丢包率丢弃的应答数
+    uint64_t ignored_{0};   // 无法解析或设备ID不存在的请求数
+};
+
+// 本地 Kingray 主机模拟器，按 KingrayControlMessage.h 的帧格式应答 PL_FUN_* 请求，用于无硬件时的压测
+// 应答沿用请求的产品ID、设备ID和功能号，消息体为 dataLen + 数据 + 校验和：
+// 设置类请求回显请求数据，获取设备名称返回 "MIC-<设备ID>"，其余返回固定长度的零数据
+// 设备ID为 0xFFFF 的广播请求由每个模拟设备各应答一次
+class KingraySimulator
+{
+public:
+    explicit KingraySimulator(const SimulatorConfig& config);
+    ~KingraySimulator();
+
+    KingraySimulator(const KingraySimulator&) = delete;
+    KingraySimulator& operator=(const KingraySimulator&) = delete;
+
+    void Start();
+    void Stop();
+
+    // 实际绑定的 UDP 端口
+    uint16_t GetUdpPort() const { return udpPort_; }
+    // pty 从设备路径，可作为 SerialProtocol 的串口名，未启用串口时为空
+    std::string GetSerialPath() const { return serialPath_; }
+    SimulatorStats GetStats() const;
+
+private:
+    using Reply = std::function<void(const std::vector<uint8_t>& frame)>;
+
+    void OpenUdp();
+    void OpenSerial();
+    void CloseSerial();
+    void OnUdpReadable();
+    void OnSerialReadable();
+    // 从串口字节流中切分完整帧，不以帧头开始的字节被丢弃以重新同步
+    void ParseSerialStream();
+    // 解析一帧请求，按配置的延迟和丢包率调度应答
+    void HandleFrame(const uint8_t* data, size_t len, const Reply& reply);
+    std::vector<uint8_t> MakeResponse(const MessageHeader& header, uint16_t deviceId, const uint8_t* body,
+                                      size_t bodyLen) const;
+    void ScheduleReply(std::vector<uint8_t> frame, const Reply& reply);
+    uint32_t NextDelayMs();
+    bool ShouldDrop();
+
+    static constexpr size_t HEADER_SIZE = 12;
+    static constexpr uint32_t DEFAULT_BODY_WORDS = 4;  // 获取类请求的默认应答数据长度(uint32 个数)
+    static constexpr uint32_t MAX_BODY_WORDS = 512;    // 超出视为不带消息体的请求
+    static constexpr uint16_t BROADCAST_DEVICE_ID = 0xFFFF;
+
+    SimulatorConfig config_;
+    std::shared_ptr<aoip::Reactor> reactor_;
+    std::unique_ptr<aoip::UdpSocket> socket_;
+    uint16_t udpPort_{0};
+    int serialFd_{-1};
+    int serialSlaveFd_{-1};  // 保持从设备打开，避免没有客户端时主设备持续报告挂断
+    std::string serialPath_;
+    std::vector<uint8_t> serialBuffer_;
+    std::mutex randomMutex_;
+    std::minstd_rand random_;
+    std::atomic<bool> running_{false};
+    std::atomic<uint64_t> received_{0};
+    std::atomic<uint64_t> replied_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> ignored_{0};
+};
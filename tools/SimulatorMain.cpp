@@ -0,0 +1,103 @@
+// Kingray 主机模拟器：在 UDP 端口（可选 pty 串口）上应答 PL_FUN_* 请求，Ctrl+C 退出
+#include <signal.h>
+#include <cstdio>
+#include <string>
+#include "KingraySimulator.h"
+
+namespace
+{
+
+void PrintUsage(const char* name)
+{
+    printf("usage: %s [options]\n"
+           "  --bind IP         bind address (default 127.0.0.1)\n"
+           "  --port N          udp port (default 60000)\n"
+           "  --serial          also serve on a pty, the slave path is printed at startup\n"
+           "  --devices N       simulated devices (default 500)\n"
+           "  --latency MS      reply latency (default 2)\n"
+           "  --jitter MS       latency jitter (default 1)\n"
+           "  --loss RATE       loss rate 0..1 (default 0)\n",
+           name);
+}
+
+bool ParseOptions(int argc, char* argv[], SimulatorConfig& config)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string key = argv[i];
+        if (key == "--serial")
+        {
+            config.serial_ = true;
+            continue;
+        }
+        if (i + 1 >= argc)
+        {
+            return false;
+        }
+        const std::string value = argv[++i];
+        if (key == "--bind") config.bindIp_ = value;
+        else if (key == "--port") config.udpPort_ = std::stoul(value);
+        else if (key == "--devices") config.deviceCount_ = std::stoul(value);
+        else if (key == "--latency") config.latencyMs_ = std::stoul(value);
+        else if (key == "--jitter") config.jitterMs_ = std::stoul(value);
+        else if (key == "--loss") config.lossRate_ = std::stod(value);
+        else return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    SimulatorConfig config;
+    try
+    {
+        if (!ParseOptions(argc, argv, config))
+        {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+    catch (const std::exception& e)
+    {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    // 在启动事件循环线程前屏蔽信号，由主线程 sigwait 统一处理
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    KingraySimulator simulator(config);
+    try
+    {
+        simulator.Start();
+    }
+    catch (const std::exception& e)
+    {
+        fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+
+    printf("udp        : %s:%u, %u devices, latency %u±%u ms, loss %.3f\n", config.bindIp_.c_str(),
+           simulator.GetUdpPort(), config.deviceCount_, config.latencyMs_, config.jitterMs_, config.lossRate_);
+    if (config.serial_)
+    {
+        printf("serial     : %s\n", simulator.GetSerialPath().c_str());
+    }
+    fflush(stdout);
+
+    int signal = 0;
+    sigwait(&signals, &signal);
+    simulator.Stop();
+
+    const auto stats = simulator.GetStats();
+    printf("received %llu, replied %llu, dropped %llu, ignored %llu\n",
+           static_cast<unsigned long long>(stats.received_), static_cast<unsigned long long>(stats.replied_),
+           static_cast<unsigned long long>(stats.dropped_), static_cast<unsigned long long>(stats.ignored_));
+    return 0;
+}